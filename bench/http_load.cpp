@@ -0,0 +1,428 @@
+/**
+ * Benchmark de requêtes HTTP
+ * Maintient N connexions sur un seul thread (epoll) pendant une durée fixe et
+ * mesure le débit et la latence de chaque requête.
+ *
+ * Modes:
+ *   keepalive  HTTP/1.1, une requête en vol par connexion
+ *   close      HTTP/1.1, une nouvelle connexion par requête
+ *   h2         HTTP/2 sans TLS (prior knowledge), `streams` requêtes en vol par connexion
+ *
+ * Usage: http_load [host] [port] [connections] [seconds] [path] [mode] [streams]
+ */
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum Mode { KEEPALIVE, CLOSE, H2 };
+
+constexpr uint32_t H2_MAX_WINDOW = 0x7fffffff;
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Client {
+    int fd = -1;
+    std::string input;
+    std::string output;
+    bool want_write = false;
+    int64_t started = 0;                                // HTTP/1.1: requête en vol
+    std::unordered_map<uint32_t, int64_t> streams;      // HTTP/2: flux en vol
+    uint32_t next_stream = 1;
+};
+
+struct Load {
+    Mode mode;
+    sockaddr_in addr;
+    std::string request;            // HTTP/1.1: requête complète, HTTP/2: bloc d'en-têtes HPACK
+    int streams;
+    int epoll_fd;
+    std::vector<int64_t> latencies;
+    uint64_t errors = 0;
+};
+
+void append_frame_header(std::string& out, uint32_t length, uint8_t type, uint8_t flags, uint32_t stream) {
+    const char header[9] = {
+        static_cast<char>(length >> 16), static_cast<char>(length >> 8), static_cast<char>(length),
+        static_cast<char>(type), static_cast<char>(flags),
+        static_cast<char>(stream >> 24), static_cast<char>(stream >> 16),
+        static_cast<char>(stream >> 8), static_cast<char>(stream)
+    };
+    out.append(header, sizeof(header));
+}
+
+void append_u32(std::string& out, uint32_t value) {
+    out += static_cast<char>(value >> 24);
+    out += static_cast<char>(value >> 16);
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value);
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+// GET en HPACK sans table dynamique: pseudo-en-têtes statiques et littéraux non indexés
+std::string h2_request_block(const char* host, const std::string& path) {
+    std::string block;
+    block += static_cast<char>(0x82);   // :method GET
+    block += static_cast<char>(0x86);   // :scheme http
+    if (path == "/") {
+        block += static_cast<char>(0x84);
+    } else {
+        block += static_cast<char>(0x04);
+        block += static_cast<char>(path.size()); // < 127 octets
+        block += path;
+    }
+    block += static_cast<char>(0x01);   // :authority
+    block += static_cast<char>(std::strlen(host));
+    block += host;
+    return block;
+}
+
+void update_events(Load& load, Client& client) {
+    bool want_write = !client.output.empty();
+    if (want_write == client.want_write) {
+        return;
+    }
+    client.want_write = want_write;
+    struct epoll_event ev;
+    ev.events = want_write ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    ev.data.ptr = &client;
+    epoll_ctl(load.epoll_fd, EPOLL_CTL_MOD, client.fd, &ev);
+}
+
+void flush(Load& load, Client& client) {
+    while (!client.output.empty()) {
+        ssize_t n = send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOTCONN) {
+                ++load.errors;
+                client.output.clear();
+            }
+            break;
+        }
+        client.output.erase(0, static_cast<size_t>(n));
+    }
+    update_events(load, client);
+}
+
+void send_h2_request(Load& load, Client& client) {
+    uint32_t id = client.next_stream;
+    client.next_stream += 2;
+    append_frame_header(client.output, static_cast<uint32_t>(load.request.size()), 0x1, 0x5, id); // END_STREAM | END_HEADERS
+    client.output += load.request;
+    client.streams[id] = now_ns();
+}
+
+// Connexion non bloquante; la première requête part dès que le socket est inscriptible
+bool open_client(Load& load, Client& client) {
+    client.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (client.fd < 0) {
+        return false;
+    }
+    int one = 1;
+    setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(client.fd, reinterpret_cast<const sockaddr*>(&load.addr), sizeof(load.addr)) < 0 &&
+        errno != EINPROGRESS) {
+        close(client.fd);
+        client.fd = -1;
+        return false;
+    }
+
+    client.input.clear();
+    client.output.clear();
+    client.started = 0;
+    client.streams.clear();
+    client.next_stream = 1;
+    if (load.mode == H2) {
+        client.output = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+        // SETTINGS: fenêtre initiale maximale, pas de push
+        append_frame_header(client.output, 12, 0x4, 0, 0);
+        client.output += std::string("\x00\x02", 2);
+        append_u32(client.output, 0);
+        client.output += std::string("\x00\x04", 2);
+        append_u32(client.output, H2_MAX_WINDOW);
+        append_frame_header(client.output, 4, 0x8, 0, 0);
+        append_u32(client.output, H2_MAX_WINDOW - 65535);
+        for (int i = 0; i < load.streams; ++i) {
+            send_h2_request(load, client);
+        }
+    } else {
+        client.output = load.request;
+        client.started = now_ns();
+    }
+
+    client.want_write = true;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = &client;
+    epoll_ctl(load.epoll_fd, EPOLL_CTL_ADD, client.fd, &ev);
+    return true;
+}
+
+void close_client(Client& client) {
+    if (client.fd >= 0) {
+        close(client.fd);
+        client.fd = -1;
+    }
+}
+
+// Réponses HTTP/1.1 complètes (corps délimité par Content-Length); false: fermer la connexion
+bool parse_http1(Load& load, Client& client) {
+    size_t head_end = client.input.find("\r\n\r\n");
+    if (head_end == std::string::npos) {
+        return true;
+    }
+    size_t length = 0;
+    bool has_length = false;
+    size_t line = client.input.find("\r\n");
+    while (line < head_end) {
+        size_t next = client.input.find("\r\n", line + 2);
+        if (strncasecmp(client.input.c_str() + line + 2, "Content-Length:", 15) == 0) {
+            length = std::strtoull(client.input.c_str() + line + 17, nullptr, 10);
+            has_length = true;
+        }
+        line = next;
+    }
+    if (!has_length || client.input.compare(0, 9, "HTTP/1.1 ") != 0) {
+        ++load.errors; // Réponse chunked ou fermée: non mesurable
+        client.started = 0;
+        return false;
+    }
+    if (client.input.size() < head_end + 4 + length) {
+        return true;
+    }
+
+    load.latencies.push_back(now_ns() - client.started);
+    if (client.input[9] != '2' && client.input[9] != '3') {
+        ++load.errors;
+    }
+    client.input.erase(0, head_end + 4 + length);
+    client.started = 0;
+    if (load.mode == CLOSE) {
+        return false;
+    }
+    client.output += load.request;
+    client.started = now_ns();
+    return true;
+}
+
+void finish_stream(Load& load, Client& client, uint32_t id, bool failed) {
+    auto it = client.streams.find(id);
+    if (it == client.streams.end()) {
+        return;
+    }
+    load.latencies.push_back(now_ns() - it->second);
+    if (failed) {
+        ++load.errors;
+    }
+    client.streams.erase(it);
+    send_h2_request(load, client);
+}
+
+// Trames HTTP/2 complètes; le corps n'est pas décodé, seule la fin de flux compte
+bool parse_http2(Load& load, Client& client) {
+    size_t offset = 0;
+    uint32_t data_bytes = 0;
+    while (client.input.size() - offset >= 9) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(client.input.data()) + offset;
+        uint32_t length = (p[0] << 16) | (p[1] << 8) | p[2];
+        if (client.input.size() - offset < 9 + length) {
+            break;
+        }
+        uint8_t type = p[3];
+        uint8_t flags = p[4];
+        uint32_t stream = read_u32(p + 5) & 0x7fffffff;
+        switch (type) {
+            case 0x0: // DATA
+                data_bytes += length;
+                if (flags & 0x1) {
+                    finish_stream(load, client, stream, false);
+                }
+                break;
+            case 0x1: // HEADERS
+                if (flags & 0x1) {
+                    finish_stream(load, client, stream, false);
+                }
+                break;
+            case 0x3: // RST_STREAM
+                finish_stream(load, client, stream, true);
+                break;
+            case 0x4: // SETTINGS
+                if (!(flags & 0x1)) {
+                    append_frame_header(client.output, 0, 0x4, 0x1, 0);
+                }
+                break;
+            case 0x6: // PING
+                if (!(flags & 0x1)) {
+                    append_frame_header(client.output, 8, 0x6, 0x1, 0);
+                    client.output.append(client.input, offset + 9, 8);
+                }
+                break;
+            case 0x7: // GOAWAY
+                ++load.errors;
+                return false;
+            default:
+                break;
+        }
+        offset += 9 + length;
+    }
+    client.input.erase(0, offset);
+
+    // Rendre à la connexion ce que les DATA ont consommé
+    if (data_bytes > 0) {
+        append_frame_header(client.output, 4, 0x8, 0, 0);
+        append_u32(client.output, data_bytes);
+    }
+    return true;
+}
+
+void handle_event(Load& load, Client& client, uint32_t events) {
+    if (events & EPOLLOUT) {
+        flush(load, client);
+    }
+    if (!(events & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+        return;
+    }
+
+    char buffer[65536];
+    bool open = true;
+    while (true) {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            client.input.append(buffer, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            open = false;
+        }
+        break;
+    }
+
+    bool keep = load.mode == H2 ? parse_http2(load, client) : parse_http1(load, client);
+    if (keep && open) {
+        flush(load, client);
+        return;
+    }
+
+    // Fermée par le serveur avant la fin d'une requête
+    if (client.started != 0 || !client.streams.empty()) {
+        ++load.errors;
+    }
+    close_client(client);
+    if (!open_client(load, client)) {
+        ++load.errors;
+    }
+}
+
+int64_t percentile(std::vector<int64_t>& values, double p) {
+    if (values.empty()) return 0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* host = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? std::atoi(argv[2]) : 8080;
+    int num_clients = argc > 3 ? std::atoi(argv[3]) : 64;
+    double seconds = argc > 4 ? std::atof(argv[4]) : 10.0;
+    std::string path = argc > 5 ? argv[5] : "/";
+    std::string mode_name = argc > 6 ? argv[6] : "keepalive";
+    int streams = argc > 7 ? std::atoi(argv[7]) : 10;
+
+    Load load;
+    if (mode_name == "keepalive") {
+        load.mode = KEEPALIVE;
+    } else if (mode_name == "close") {
+        load.mode = CLOSE;
+    } else if (mode_name == "h2") {
+        load.mode = H2;
+    } else {
+        std::fprintf(stderr, "Mode inconnu: %s (keepalive, close ou h2)\n", mode_name.c_str());
+        return 1;
+    }
+    load.streams = std::max(1, streams);
+    load.request = load.mode == H2
+        ? h2_request_block(host, path)
+        : "GET " + path + " HTTP/1.1\r\nHost: " + host + (load.mode == CLOSE ? "\r\nConnection: close" : "") + "\r\n\r\n";
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    std::memset(&load.addr, 0, sizeof(load.addr));
+    load.addr.sin_family = AF_INET;
+    load.addr.sin_port = htons(port);
+    inet_pton(AF_INET, host, &load.addr.sin_addr);
+
+    load.epoll_fd = epoll_create1(0);
+    std::vector<Client> clients(num_clients);
+    for (auto& client : clients) {
+        if (!open_client(load, client)) {
+            std::fprintf(stderr, "Connexion impossible\n");
+            return 1;
+        }
+    }
+
+    std::vector<epoll_event> events(1024);
+    int64_t start = now_ns();
+    int64_t deadline = start + static_cast<int64_t>(seconds * 1e9);
+    int64_t now = start;
+    while (now < deadline) {
+        int n = epoll_wait(load.epoll_fd, events.data(), static_cast<int>(events.size()), 100);
+        for (int i = 0; i < n; ++i) {
+            handle_event(load, *static_cast<Client*>(events[i].data.ptr), events[i].events);
+        }
+        now = now_ns();
+    }
+    double elapsed = (now - start) / 1e9;
+    size_t completed = load.latencies.size();
+
+    std::printf("%s %s, %d connexions%s: %zu requêtes en %.1f s, %llu erreurs\n",
+                mode_name.c_str(), path.c_str(), num_clients,
+                load.mode == H2 ? (" x " + std::to_string(load.streams) + " flux").c_str() : "",
+                completed, elapsed, static_cast<unsigned long long>(load.errors));
+    std::printf("  %.0f req/s\n", completed / elapsed);
+    std::printf("  latence (µs): p50=%lld p99=%lld max=%lld\n",
+                static_cast<long long>(percentile(load.latencies, 0.50) / 1000),
+                static_cast<long long>(percentile(load.latencies, 0.99) / 1000),
+                static_cast<long long>(percentile(load.latencies, 1.0) / 1000));
+
+    for (auto& client : clients) {
+        close_client(client);
+    }
+    close(load.epoll_fd);
+    return 0;
+}
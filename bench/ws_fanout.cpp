@@ -0,0 +1,239 @@
+/**
+ * Benchmark de diffusion WebSocket
+ * Ouvre N clients sur /ws, envoie un message horodaté depuis un client
+ * émetteur et mesure le délai de réception sur chaque abonné.
+ *
+ * Usage: ws_fanout [host] [port] [clients] [rounds]
+ */
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// Connexion bloquante + poignée de main; retourne -1 en cas d'échec
+int open_client(const sockaddr_in& addr) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    std::string request =
+        "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (!send_all(fd, request)) {
+        close(fd);
+        return -1;
+    }
+
+    // Lire la réponse octet par octet jusqu'au double CRLF: aucune trame n'est consommée
+    std::string response;
+    char c;
+    while (response.size() < 4096 && recv(fd, &c, 1, 0) == 1) {
+        response += c;
+        if (response.size() >= 4 && response.compare(response.size() - 4, 4, "\r\n\r\n") == 0) {
+            break;
+        }
+    }
+    if (response.compare(0, 12, "HTTP/1.1 101") != 0) {
+        close(fd);
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+std::string masked_text_frame(const std::string& payload) {
+    std::string frame;
+    frame += static_cast<char>(0x81);
+    frame += static_cast<char>(0x80 | payload.size()); // < 126 octets
+    const char mask[4] = {0x12, 0x34, 0x56, 0x78};
+    frame.append(mask, 4);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame += static_cast<char>(payload[i] ^ mask[i & 3]);
+    }
+    return frame;
+}
+
+struct Client {
+    int fd;
+    std::string input;
+};
+
+// Extraire les payloads des trames serveur (non masquées) complètes
+void extract_messages(std::string& input, std::vector<std::string>& messages) {
+    size_t offset = 0;
+    while (input.size() - offset >= 2) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(input.data()) + offset;
+        uint64_t len = p[1] & 0x7f;
+        size_t header = 2;
+        if (len == 126) {
+            if (input.size() - offset < 4) break;
+            len = (p[2] << 8) | p[3];
+            header = 4;
+        } else if (len == 127) {
+            if (input.size() - offset < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; ++i) len = (len << 8) | p[2 + i];
+            header = 10;
+        }
+        if (input.size() - offset < header + len) break;
+        if ((p[0] & 0x0f) == 0x1) {
+            messages.emplace_back(input, offset + header, len);
+        }
+        offset += header + len;
+    }
+    input.erase(0, offset);
+}
+
+int64_t percentile(std::vector<int64_t>& values, double p) {
+    if (values.empty()) return 0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* host = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? std::atoi(argv[2]) : 8080;
+    int num_clients = argc > 3 ? std::atoi(argv[3]) : 10000;
+    int rounds = argc > 4 ? std::atoi(argv[4]) : 20;
+
+    // Un descripteur par client
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, host, &addr.sin_addr);
+
+    int sender = open_client(addr);
+    if (sender < 0) {
+        std::fprintf(stderr, "Connexion de l'émetteur impossible\n");
+        return 1;
+    }
+
+    int epoll_fd = epoll_create1(0);
+    std::vector<Client> clients;
+    clients.reserve(num_clients);
+    for (int i = 0; i < num_clients; ++i) {
+        int fd = open_client(addr);
+        if (fd < 0) {
+            std::fprintf(stderr, "Connexion %d échouée, arrêt à %zu clients\n", i, clients.size());
+            break;
+        }
+        clients.push_back({fd, std::string()});
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(clients.size() - 1);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    std::printf("%zu clients connectés\n", clients.size());
+
+    std::vector<int64_t> all_latencies;
+    std::vector<int64_t> last_latencies;
+    std::vector<epoll_event> events(1024);
+    std::vector<std::string> messages;
+    char buffer[65536];
+
+    for (int round = 0; round < rounds; ++round) {
+        int64_t start = now_ns();
+        std::string payload = "round:" + std::to_string(round);
+        if (!send_all(sender, masked_text_frame(payload))) {
+            std::fprintf(stderr, "Envoi impossible\n");
+            return 1;
+        }
+
+        size_t received = 0;
+        int64_t last = 0;
+        while (received < clients.size()) {
+            int n = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), 5000);
+            if (n <= 0) {
+                std::fprintf(stderr, "Délai dépassé: %zu/%zu reçus\n", received, clients.size());
+                break;
+            }
+            int64_t now = now_ns();
+            for (int i = 0; i < n; ++i) {
+                Client& client = clients[events[i].data.u32];
+                ssize_t r;
+                while ((r = recv(client.fd, buffer, sizeof(buffer), 0)) > 0) {
+                    client.input.append(buffer, r);
+                }
+                messages.clear();
+                extract_messages(client.input, messages);
+                for (const auto& message : messages) {
+                    if (message == payload) {
+                        ++received;
+                        all_latencies.push_back(now - start);
+                        last = now - start;
+                    }
+                }
+            }
+        }
+        last_latencies.push_back(last);
+
+        // Vider la copie reçue par l'émetteur lui-même
+        while (recv(sender, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+        }
+    }
+
+    std::printf("Latence de diffusion sur %zu clients, %d tours (µs):\n", clients.size(), rounds);
+    std::printf("  p50=%lld p99=%lld max=%lld\n",
+                static_cast<long long>(percentile(all_latencies, 0.50) / 1000),
+                static_cast<long long>(percentile(all_latencies, 0.99) / 1000),
+                static_cast<long long>(percentile(all_latencies, 1.0) / 1000));
+    std::printf("  dernier client: p50=%lld max=%lld\n",
+                static_cast<long long>(percentile(last_latencies, 0.50) / 1000),
+                static_cast<long long>(percentile(last_latencies, 1.0) / 1000));
+
+    for (auto& client : clients) {
+        close(client.fd);
+    }
+    close(sender);
+    close(epoll_fd);
+    return 0;
+}
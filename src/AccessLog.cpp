@@ -0,0 +1,223 @@
+#include "AccessLog.h"
+#include "RecordFormat.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+namespace {
+
+constexpr size_t BATCH_BYTES = 64 * 1024;
+constexpr auto IDLE_SLEEP = std::chrono::milliseconds(5);
+
+} // namespace
+
+AccessLog::AccessLog(const std::string& path, Format format, size_t max_producers,
+                     uint64_t max_file_bytes, int max_files, size_t ring_capacity)
+    : path_(path), format_(format), max_file_bytes_(max_file_bytes), max_files_(max_files) {
+    rings_.reserve(max_producers);
+    for (size_t i = 0; i < max_producers; ++i) {
+        rings_.push_back(std::make_unique<SpscRing<AccessLogRecord>>(ring_capacity));
+    }
+}
+
+AccessLog::~AccessLog() {
+    stop();
+}
+
+bool AccessLog::parse_format(const std::string& name, Format& format) {
+    if (name == "common") {
+        format = COMMON;
+    } else if (name == "json") {
+        format = JSON;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool AccessLog::start() {
+    if (running_) {
+        return true;
+    }
+    if (!open_file()) {
+        std::cerr << "Erreur: impossible d'ouvrir l'access log " << path_ << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    drain_thread_ = std::thread(&AccessLog::drain_loop, this);
+    return true;
+}
+
+void AccessLog::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (drain_thread_.joinable()) {
+        drain_thread_.join();
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+SpscRing<AccessLogRecord>* AccessLog::producer_ring() {
+    size_t index = slot_.index();
+    return index < rings_.size() ? rings_[index].get() : nullptr;
+}
+
+void AccessLog::log(const AccessLogRecord& record) {
+    SpscRing<AccessLogRecord>* ring = producer_ring();
+    if (!ring || !ring->try_push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AccessLog::drain_loop() {
+    std::string batch;
+    batch.reserve(BATCH_BYTES * 2);
+
+    while (running_) {
+        if (drain_once(batch) == 0) {
+            write_batch(batch);
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+
+    // Vider ce qui reste après l'arrêt des producteurs
+    while (drain_once(batch) > 0) {
+    }
+    write_batch(batch);
+}
+
+size_t AccessLog::drain_once(std::string& batch) {
+    size_t count = 0;
+    AccessLogRecord record;
+
+    for (auto& ring : rings_) {
+        // Limiter par ring pour rester équitable entre workers
+        for (size_t i = 0; i < 256 && ring->try_pop(record); ++i) {
+            format_record(record, batch);
+            ++count;
+        }
+        if (batch.size() >= BATCH_BYTES) {
+            write_batch(batch);
+        }
+    }
+
+    return count;
+}
+
+void AccessLog::format_record(const AccessLogRecord& record, std::string& out) {
+    char ip[INET_ADDRSTRLEN];
+    struct in_addr addr;
+    addr.s_addr = record.client_ip;
+    inet_ntop(AF_INET, &addr, ip, sizeof(ip));
+
+    // Les enregistrements d'une même seconde partagent le même texte
+    int64_t second = static_cast<int64_t>(record.timestamp_us / 1000000);
+    if (second != time_second_) {
+        time_t seconds = static_cast<time_t>(second);
+        struct tm tm;
+        gmtime_r(&seconds, &tm);
+        char time_buf[64];
+        strftime(time_buf, sizeof(time_buf),
+                 format_ == COMMON ? "%d/%b/%Y:%H:%M:%S +0000" : "%Y-%m-%dT%H:%M:%S", &tm);
+        time_text_ = time_buf;
+        time_second_ = second;
+    }
+    char line[128];
+
+    if (format_ == COMMON) {
+        // 127.0.0.1 - - [10/Oct/2000:13:55:36 +0000] "GET / HTTP/1.1" 200 2326
+        out += ip;
+        out += " - - [";
+        out += time_text_;
+        // Ligne entre guillemets: même échappement qu'en JSON, un chemin forgé ne peut pas la couper
+        out += "] \"";
+        RecordFormat::append_json_string(out, record.method);
+        out += ' ';
+        RecordFormat::append_json_string(out, record.path);
+        out += ' ';
+        RecordFormat::append_json_string(out, record.protocol);
+        std::snprintf(line, sizeof(line), "\" %u %llu\n", record.status,
+                      static_cast<unsigned long long>(record.bytes_sent));
+        out += line;
+    } else {
+        out += "{\"time\":\"";
+        out += time_text_;
+        std::snprintf(line, sizeof(line), ".%06lldZ\",\"remote\":\"",
+                      static_cast<long long>(record.timestamp_us % 1000000));
+        out += line;
+        out += ip;
+        out += "\",\"method\":\"";
+        RecordFormat::append_json_string(out, record.method);
+        out += "\",\"path\":\"";
+        RecordFormat::append_json_string(out, record.path);
+        out += "\",\"protocol\":\"";
+        RecordFormat::append_json_string(out, record.protocol);
+        std::snprintf(line, sizeof(line), "\",\"status\":%u,\"bytes\":%llu,\"duration_us\":%u}\n",
+                      record.status, static_cast<unsigned long long>(record.bytes_sent),
+                      record.duration_us);
+        out += line;
+    }
+}
+
+void AccessLog::write_batch(std::string& batch) {
+    if (batch.empty() || fd_ < 0) {
+        batch.clear();
+        return;
+    }
+
+    if (max_files_ > 0 && file_bytes_ + batch.size() > max_file_bytes_ && file_bytes_ > 0) {
+        rotate();
+    }
+
+    size_t offset = 0;
+    while (offset < batch.size()) {
+        ssize_t n = ::write(fd_, batch.data() + offset, batch.size() - offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += n;
+    }
+
+    file_bytes_ += offset;
+    batch.clear();
+}
+
+bool AccessLog::open_file() {
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+    off_t size = ::lseek(fd_, 0, SEEK_END);
+    file_bytes_ = size > 0 ? static_cast<uint64_t>(size) : 0;
+    return true;
+}
+
+void AccessLog::rotate() {
+    ::close(fd_);
+    fd_ = -1;
+
+    // access.log.(n-1) -> access.log.n, ..., access.log -> access.log.1
+    for (int i = max_files_ - 1; i >= 1; --i) {
+        std::string from = path_ + "." + std::to_string(i);
+        std::string to = path_ + "." + std::to_string(i + 1);
+        std::rename(from.c_str(), to.c_str());
+    }
+    std::rename(path_.c_str(), (path_ + ".1").c_str());
+
+    if (!open_file()) {
+        std::cerr << "Erreur: réouverture de l'access log échouée" << std::endl;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include "ThreadSlot.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Enregistrement binaire de taille fixe d'une requête servie
+ * Copié tel quel dans le ring buffer, formaté par le thread de vidage
+ */
+struct AccessLogRecord {
+    int64_t timestamp_us = 0;     // Heure de réception (epoch, µs)
+    uint32_t duration_us = 0;     // Durée de traitement
+    uint32_t client_ip = 0;       // IPv4, ordre réseau
+    uint64_t bytes_sent = 0;
+    uint16_t status = 0;
+    char method[8] = {};
+    char protocol[10] = {};
+    char path[128] = {};          // Tronqué si plus long
+};
+
+/**
+ * Access log asynchrone
+ * Chaque worker écrit dans son propre ring buffer lock-free; un thread
+ * dédié formate les enregistrements (common ou JSON) et les écrit par lots
+ * avec rotation des fichiers. Si le vidage prend du retard, les
+ * enregistrements sont abandonnés et comptés.
+ */
+class AccessLog {
+public:
+    enum Format {
+        COMMON,
+        JSON
+    };
+
+    AccessLog(const std::string& path, Format format, size_t max_producers,
+              uint64_t max_file_bytes = 100 * 1024 * 1024, int max_files = 5,
+              size_t ring_capacity = 8192);
+    ~AccessLog();
+
+    // Non-copyable, non-movable
+    AccessLog(const AccessLog&) = delete;
+    AccessLog& operator=(const AccessLog&) = delete;
+    AccessLog(AccessLog&&) = delete;
+    AccessLog& operator=(AccessLog&&) = delete;
+
+    // Ouvrir le fichier et démarrer le thread de vidage
+    bool start();
+
+    // Vider les enregistrements restants et arrêter le thread
+    void stop();
+
+    // Chemin critique: copie dans le ring du thread courant, sans appel système
+    void log(const AccessLogRecord& record);
+
+    static bool parse_format(const std::string& name, Format& format);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::string path_;
+    Format format_;
+    uint64_t max_file_bytes_;
+    int max_files_;
+
+    std::vector<std::unique_ptr<SpscRing<AccessLogRecord>>> rings_;
+    ThreadSlot<AccessLog> slot_;
+    std::atomic<uint64_t> dropped_{0};
+
+    int fd_ = -1;
+    uint64_t file_bytes_ = 0;
+
+    // Horodatage formaté de la dernière seconde vue (thread de vidage uniquement)
+    int64_t time_second_ = -1;
+    std::string time_text_;
+    std::thread drain_thread_;
+    std::atomic<bool> running_{false};
+
+    // Ring du thread courant (attribué au premier appel)
+    SpscRing<AccessLogRecord>* producer_ring();
+
+    void drain_loop();
+    size_t drain_once(std::string& batch);
+    void format_record(const AccessLogRecord& record, std::string& out);
+    void write_batch(std::string& batch);
+    bool open_file();
+    void rotate();
+};
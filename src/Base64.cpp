@@ -0,0 +1,72 @@
+#include "Base64.h"
+
+namespace {
+
+const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int decode_char(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return -1;
+}
+
+} // namespace
+
+std::string Base64::encode(const unsigned char* data, size_t len) {
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        unsigned int triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out += ALPHABET[(triple >> 18) & 0x3f];
+        out += ALPHABET[(triple >> 12) & 0x3f];
+        out += ALPHABET[(triple >> 6) & 0x3f];
+        out += ALPHABET[triple & 0x3f];
+    }
+
+    if (i < len) {
+        unsigned int triple = data[i] << 16;
+        if (i + 1 < len) {
+            triple |= data[i + 1] << 8;
+        }
+        out += ALPHABET[(triple >> 18) & 0x3f];
+        out += ALPHABET[(triple >> 12) & 0x3f];
+        out += (i + 1 < len) ? ALPHABET[(triple >> 6) & 0x3f] : '=';
+        out += '=';
+    }
+
+    return out;
+}
+
+std::string Base64::encode(const std::string& data) {
+    return encode(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+bool Base64::decode(const std::string& input, std::string& output) {
+    output.clear();
+    unsigned int accumulator = 0;
+    int bits = 0;
+
+    for (char c : input) {
+        if (c == '=') {
+            break;
+        }
+        int value = decode_char(c);
+        if (value < 0) {
+            return false;
+        }
+        accumulator = (accumulator << 6) | static_cast<unsigned int>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            output += static_cast<char>((accumulator >> bits) & 0xff);
+        }
+    }
+
+    // Un seul caractère dans le dernier groupe ne peut pas former un octet
+    return bits < 6;
+}
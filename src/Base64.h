@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Encodage Base64 (RFC 4648), alphabets standard et "URL-safe"
+ */
+class Base64 {
+public:
+    static std::string encode(const unsigned char* data, size_t len);
+    static std::string encode(const std::string& data);
+
+    // Accepte les deux alphabets, avec ou sans bourrage '='
+    static bool decode(const std::string& input, std::string& output);
+};
@@ -1,12 +1,47 @@
 #include "Connection.h"
+#include "Http2Session.h"
+#include "WebSocketHub.h"
+#include <sys/sendfile.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
+#include <errno.h>
 
-Connection::Connection(int sockfd, const struct sockaddr_in& addr)
-    : fd(sockfd), address(addr), buffer(8192), bytes_read(0), keep_alive(false) {
+#ifdef HTTP_SERVER_TLS
+#include "TlsContext.h"
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+namespace {
+
+// Limite du noyau pour un appel à sendfile
+constexpr size_t MAX_SENDFILE_BYTES = 0x7ffff000;
+
+void free_ssl(SSL* ssl) {
+#ifdef HTTP_SERVER_TLS
+    if (ssl) {
+        // close_notify au mieux, sans attendre la réponse du client
+        if (SSL_is_init_finished(ssl)) {
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+    }
+#else
+    (void)ssl;
+#endif
+}
+
+} // namespace
+
+Connection::Connection(int sockfd, const struct sockaddr_in& addr, SSL* tls)
+    : fd(sockfd), address(addr), buffer(8192), bytes_read(0), keep_alive(false),
+      accepted_ns(0), request_count(0), h2_output_sent(0),
+      ssl(tls), tls_established(false), ktls_send(false) {
 }
 
 Connection::~Connection() {
+    free_ssl(ssl);
     if (fd >= 0) {
         ::close(fd);
     }
@@ -15,12 +50,18 @@ Connection::~Connection() {
 Connection::Connection(Connection&& other) noexcept
     : fd(other.fd), address(other.address), 
       buffer(std::move(other.buffer)), bytes_read(other.bytes_read),
-      keep_alive(other.keep_alive) {
+      keep_alive(other.keep_alive), request_start(other.request_start),
+      accepted_ns(other.accepted_ns), request_count(other.request_count),
+      h2(std::move(other.h2)), h2_output(std::move(other.h2_output)), h2_output_sent(other.h2_output_sent),
+      ws(std::move(other.ws)), zerocopy(std::move(other.zerocopy)),
+      ssl(other.ssl), tls_established(other.tls_established), ktls_send(other.ktls_send) {
     other.fd = -1;
+    other.ssl = nullptr;
 }
 
 Connection& Connection::operator=(Connection&& other) noexcept {
     if (this != &other) {
+        free_ssl(ssl);
         if (fd >= 0) {
             ::close(fd);
         }
@@ -29,7 +70,19 @@ Connection& Connection::operator=(Connection&& other) noexcept {
         buffer = std::move(other.buffer);
         bytes_read = other.bytes_read;
         keep_alive = other.keep_alive;
+        request_start = other.request_start;
+        accepted_ns = other.accepted_ns;
+        request_count = other.request_count;
+        h2 = std::move(other.h2);
+        h2_output = std::move(other.h2_output);
+        h2_output_sent = other.h2_output_sent;
+        ws = std::move(other.ws);
+        zerocopy = std::move(other.zerocopy);
+        ssl = other.ssl;
+        tls_established = other.tls_established;
+        ktls_send = other.ktls_send;
         other.fd = -1;
+        other.ssl = nullptr;
     }
     return *this;
 }
@@ -40,3 +93,112 @@ void Connection::reset() {
     buffer.clear();
     buffer.resize(8192);
 }
+
+ssize_t Connection::read(void* data, size_t len) {
+#ifdef HTTP_SERVER_TLS
+    if (ssl) {
+        std::lock_guard<std::mutex> lock(tls_mutex_);
+        ERR_clear_error();
+        return tls_result(SSL_read(ssl, data, static_cast<int>(len)));
+    }
+#endif
+    return ::recv(fd, data, len, 0);
+}
+
+ssize_t Connection::write(const void* data, size_t len) {
+#ifdef HTTP_SERVER_TLS
+    if (ssl && !ktls_send) {
+        std::lock_guard<std::mutex> lock(tls_mutex_);
+        ERR_clear_error();
+        return tls_result(SSL_write(ssl, data, static_cast<int>(len)));
+    }
+#endif
+    // En clair ou avec kTLS: le noyau chiffre lui-même
+    return ::send(fd, data, len, MSG_NOSIGNAL);
+}
+
+ssize_t Connection::writev(const struct iovec* iov, int count) {
+#ifdef HTTP_SERVER_TLS
+    if (ssl && !ktls_send) {
+        // TLS en espace utilisateur: un enregistrement par buffer
+        return count > 0 ? write(iov[0].iov_base, iov[0].iov_len) : 0;
+    }
+#endif
+    return ::writev(fd, iov, count);
+}
+
+ssize_t Connection::sendfile(int file_fd, size_t offset, size_t len) {
+#ifdef HTTP_SERVER_TLS
+    if (ssl && !ktls_send) {
+        errno = ENOTSUP; // OpenSSL doit voir les octets pour les chiffrer
+        return -1;
+    }
+#endif
+    // En clair ou avec kTLS: les pages du fichier vont du page cache au socket
+    off_t file_offset = static_cast<off_t>(offset);
+    return ::sendfile(fd, file_fd, &file_offset, std::min<size_t>(len, MAX_SENDFILE_BYTES));
+}
+
+bool Connection::has_buffered_input() {
+#ifdef HTTP_SERVER_TLS
+    if (ssl) {
+        std::lock_guard<std::mutex> lock(tls_mutex_);
+        return SSL_pending(ssl) > 0;
+    }
+#endif
+    return false;
+}
+
+Connection::HandshakeResult Connection::tls_handshake() {
+#ifdef HTTP_SERVER_TLS
+    std::lock_guard<std::mutex> lock(tls_mutex_);
+    ERR_clear_error();
+    int ret = SSL_do_handshake(ssl);
+    if (ret == 1) {
+        tls_established = true;
+        ktls_send = TlsContext::ktls_send_enabled(ssl);
+        return HANDSHAKE_DONE;
+    }
+
+    switch (SSL_get_error(ssl, ret)) {
+        case SSL_ERROR_WANT_READ:
+            return HANDSHAKE_WANT_READ;
+        case SSL_ERROR_WANT_WRITE:
+            return HANDSHAKE_WANT_WRITE;
+        default:
+            ERR_clear_error();
+            return HANDSHAKE_FAILED;
+    }
+#else
+    return HANDSHAKE_FAILED;
+#endif
+}
+
+ssize_t Connection::tls_result(int ret) {
+#ifdef HTTP_SERVER_TLS
+    if (ret > 0) {
+        return ret;
+    }
+
+    switch (SSL_get_error(ssl, ret)) {
+        case SSL_ERROR_WANT_READ:
+        case SSL_ERROR_WANT_WRITE:
+            errno = EAGAIN;
+            return -1;
+        case SSL_ERROR_ZERO_RETURN:
+            return 0; // close_notify reçu
+        case SSL_ERROR_SYSCALL:
+            if (errno == 0) {
+                errno = ECONNRESET;
+            }
+            ERR_clear_error();
+            return -1;
+        default:
+            ERR_clear_error();
+            errno = EIO;
+            return -1;
+    }
+#else
+    return ret;
+#endif
+}
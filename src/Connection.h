@@ -1,10 +1,20 @@
 #pragma once
 
+#include "ZeroCopy.h"
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+class Http2Session;
+class WebSocketSession;
+typedef struct ssl_st SSL;
+
 /**
  * Gère une connexion client
  */
@@ -15,8 +25,29 @@ public:
     std::vector<char> buffer;
     size_t bytes_read;
     bool keep_alive;
+    std::chrono::steady_clock::time_point request_start; // Premier octet de la requête courante
+    int64_t accepted_ns;                                 // accept() (traçage), 0 si non mesuré
+    uint32_t request_count;                              // Requêtes HTTP/1.x servies
+    std::unique_ptr<Http2Session> h2;                    // Session HTTP/2 après préface ou Upgrade
+    std::string h2_output;                               // Trames HTTP/2 pas encore acceptées par le socket
+    size_t h2_output_sent;
+    std::shared_ptr<WebSocketSession> ws;                // Session WebSocket (partagée avec le hub)
+
+    std::unique_ptr<ZeroCopySender> zerocopy;           // Envois MSG_ZEROCOPY, nullptr si désactivés
+
+    // TLS (nullptr pour une connexion en clair)
+    SSL* ssl;
+    bool tls_established;
+    bool ktls_send;                                      // Émission chiffrée par le noyau
 
-    Connection(int sockfd, const struct sockaddr_in& addr);
+    enum HandshakeResult {
+        HANDSHAKE_DONE,
+        HANDSHAKE_WANT_READ,
+        HANDSHAKE_WANT_WRITE,
+        HANDSHAKE_FAILED
+    };
+
+    Connection(int sockfd, const struct sockaddr_in& addr, SSL* tls = nullptr);
     ~Connection();
 
     // Non-copyable
@@ -28,4 +59,26 @@ public:
     Connection& operator=(Connection&& other) noexcept;
 
     void reset();
+
+    // E/S indépendantes du transport (clair, TLS en espace utilisateur ou kTLS),
+    // sémantique de recv/send: -1 et errno = EAGAIN si l'opération doit être retentée
+    ssize_t read(void* data, size_t len);
+    ssize_t write(const void* data, size_t len);
+    ssize_t writev(const struct iovec* iov, int count);
+
+    // Plage d'un fichier envoyée sans copie en espace utilisateur (clair ou kTLS);
+    // -1 et errno = ENOTSUP quand OpenSSL chiffre lui-même
+    ssize_t sendfile(int file_fd, size_t offset, size_t len);
+
+    // Octets déjà déchiffrés par OpenSSL, invisibles pour epoll
+    bool has_buffered_input();
+
+    // Faire avancer la poignée de main TLS non bloquante
+    HandshakeResult tls_handshake();
+
+private:
+    // SSL_read et SSL_write ne peuvent pas être concurrents (lecteur WebSocket et diffusions)
+    std::mutex tls_mutex_;
+
+    ssize_t tls_result(int ret);
 };
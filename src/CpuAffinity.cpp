@@ -0,0 +1,66 @@
+#include "CpuAffinity.h"
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+bool CpuAffinity::parse_cpu_list(const std::string& list, std::vector<int>& cpus) {
+    std::istringstream stream(list);
+    std::string range;
+
+    while (std::getline(stream, range, ',')) {
+        // Trim (le fichier sysfs se termine par \n)
+        range.erase(0, range.find_first_not_of(" \t\n"));
+        range.erase(range.find_last_not_of(" \t\n") + 1);
+        if (range.empty()) {
+            continue;
+        }
+
+        char* end = nullptr;
+        long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = std::strtol(end + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+
+        for (long cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+
+    return !cpus.empty();
+}
+
+std::vector<int> CpuAffinity::cpus_of_numa_node(int node) {
+    std::vector<int> cpus;
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (file && std::getline(file, list)) {
+        parse_cpu_list(list, cpus);
+    }
+    return cpus;
+}
+
+bool CpuAffinity::pin_current_thread(int cpu) {
+    return pin_current_thread(std::vector<int>{cpu});
+}
+
+bool CpuAffinity::pin_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * Placement des threads sur les cœurs CPU et les nœuds NUMA
+ */
+class CpuAffinity {
+public:
+    // Parser une liste de CPUs au format du noyau ("0-3,8,10-11")
+    static bool parse_cpu_list(const std::string& list, std::vector<int>& cpus);
+
+    // CPUs appartenant à un nœud NUMA (lus depuis /sys), vide si inconnu
+    static std::vector<int> cpus_of_numa_node(int node);
+
+    // Épingler le thread courant sur un CPU
+    static bool pin_current_thread(int cpu);
+
+    // Épingler le thread courant sur un ensemble de CPUs
+    static bool pin_current_thread(const std::vector<int>& cpus);
+};
@@ -0,0 +1,336 @@
+#include "FileCache.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace {
+
+struct MimeType {
+    const char* extension;
+    const char* type;
+};
+
+const MimeType MIME_TYPES[] = {
+    {"html", "text/html; charset=utf-8"},
+    {"htm", "text/html; charset=utf-8"},
+    {"css", "text/css; charset=utf-8"},
+    {"js", "text/javascript; charset=utf-8"},
+    {"json", "application/json"},
+    {"txt", "text/plain; charset=utf-8"},
+    {"xml", "application/xml"},
+    {"svg", "image/svg+xml"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"ico", "image/x-icon"},
+    {"woff2", "font/woff2"},
+    {"wasm", "application/wasm"},
+    {"pdf", "application/pdf"},
+    {"mp4", "video/mp4"},
+};
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Un fichier plus gros qu'un quart du budget n'est jamais conservé en mémoire
+constexpr size_t MAX_FILE_FRACTION = 4;
+
+// Lecture par blocs des fichiers hachés sans être conservés
+constexpr size_t HASH_BLOCK_SIZE = 64 * 1024;
+
+// FNV-1a 64 bits: une passe sur le contenu à chaque nouvelle version
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+
+uint64_t fnv1a(const char* data, size_t len, uint64_t hash) {
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Lire exactement len octets à partir de offset; false si le fichier a raccourci
+bool pread_all(int fd, char* data, size_t len, off_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(fd, data + done, len - done, offset + static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int64_t mtime_ns_of(const struct stat& st) {
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+FileDescriptor::~FileDescriptor() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+FileCache::FileCache(const std::string& root, size_t max_bytes)
+    : root_(root), max_bytes_(max_bytes) {
+    // Racine canonique: comparée aux cibles résolues par lookup
+    char resolved[PATH_MAX];
+    if (realpath(root_.c_str(), resolved)) {
+        root_ = resolved;
+    }
+    while (root_.size() > 1 && root_.back() == '/') {
+        root_.pop_back();
+    }
+}
+
+std::shared_ptr<const CachedFile> FileCache::lookup(const std::string& request_path,
+                                                    std::shared_ptr<const FileDescriptor>& disk) {
+    std::string path = normalize_path(request_path);
+    if (path.empty()) {
+        return nullptr;
+    }
+
+    // Liens symboliques résolus: la cible doit rester sous la racine
+    char resolved[PATH_MAX];
+    std::string file_path;
+    if (realpath((root_ + path).c_str(), resolved) && under_root(resolved)) {
+        file_path = resolved;
+    }
+    struct stat st;
+    if (file_path.empty() || stat(file_path.c_str(), &st) < 0 || !S_ISREG(st.st_mode)) {
+        // Fichier supprimé ou remplacé: l'entrée ne doit plus être servie
+        std::lock_guard<std::mutex> lock(mutex_);
+        erase(path);
+        return nullptr;
+    }
+
+    std::shared_ptr<const CachedFile> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(path);
+        if (it != entries_.end() && same_version(*it->second.file, st)) {
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            if (it->second.file->content) {
+                return it->second.file;
+            }
+            cached = it->second.file;
+        }
+    }
+
+    // Contenu sur disque: les validateurs doivent décrire le fichier effectivement ouvert
+    // Chemin déjà résolu: un lien apparu depuis realpath() n'est pas suivi
+    int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+    if (fd < 0) {
+        return nullptr;
+    }
+    auto file = std::make_shared<const FileDescriptor>(fd);
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        return nullptr;
+    }
+    if (cached && same_version(*cached, st)) {
+        disk = std::move(file);
+        return cached;
+    }
+
+    // Nouvelle version: lecture hors verrou, deux workers peuvent la charger en parallèle
+    std::shared_ptr<const CachedFile> entry = load(file_path, fd, st);
+    if (!entry) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        store(path, entry);
+    }
+    if (!entry->content) {
+        disk = std::move(file);
+    }
+    return entry;
+}
+
+size_t FileCache::size_bytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+}
+
+bool FileCache::under_root(const std::string& resolved) const {
+    if (root_ == "/") {
+        return true;
+    }
+    return resolved.size() > root_.size() && resolved.compare(0, root_.size(), root_) == 0 &&
+           resolved[root_.size()] == '/';
+}
+
+bool FileCache::same_version(const CachedFile& file, const struct stat& st) {
+    return file.inode == st.st_ino && file.device == st.st_dev &&
+           file.size == static_cast<size_t>(st.st_size) && file.mtime_ns == mtime_ns_of(st);
+}
+
+std::shared_ptr<const CachedFile> FileCache::load(const std::string& file_path, int fd, const struct stat& st) {
+    auto entry = std::make_shared<CachedFile>();
+    entry->size = static_cast<size_t>(st.st_size);
+    entry->content_type = content_type_for(file_path);
+    entry->mtime = st.st_mtim.tv_sec;
+    entry->last_modified = http_date(entry->mtime);
+    entry->device = st.st_dev;
+    entry->inode = st.st_ino;
+    entry->mtime_ns = mtime_ns_of(st);
+
+    // Fichier tronqué pendant la lecture: le prochain stat() verra la nouvelle version
+    uint64_t hash = FNV_OFFSET_BASIS;
+    if (entry->size <= max_bytes_ / MAX_FILE_FRACTION) {
+        auto content = std::make_shared<std::string>(entry->size, '\0');
+        if (!pread_all(fd, &(*content)[0], content->size(), 0)) {
+            return nullptr;
+        }
+        hash = fnv1a(content->data(), content->size(), hash);
+        entry->content = std::move(content);
+    } else {
+        // Trop gros pour le cache: haché une fois par version, servi depuis le disque
+        std::vector<char> block(HASH_BLOCK_SIZE);
+        for (size_t offset = 0; offset < entry->size; offset += block.size()) {
+            size_t len = std::min(block.size(), entry->size - offset);
+            if (!pread_all(fd, block.data(), len, static_cast<off_t>(offset))) {
+                return nullptr;
+            }
+            hash = fnv1a(block.data(), len, hash);
+        }
+    }
+
+    // ETag fort: dépend uniquement des octets servis
+    char etag[48];
+    std::snprintf(etag, sizeof(etag), "\"%zx-%016llx\"", entry->size,
+                  static_cast<unsigned long long>(hash));
+    entry->etag = etag;
+    return entry;
+}
+
+void FileCache::store(const std::string& path, const std::shared_ptr<const CachedFile>& file) {
+    erase(path);
+
+    // Évincer les entrées les moins récemment servies jusqu'à tenir le budget
+    size_t bytes = file->content ? file->size : 0;
+    while (!lru_.empty() && (total_bytes_ + bytes > max_bytes_ || entries_.size() >= MAX_ENTRIES)) {
+        std::string oldest = lru_.back();
+        erase(oldest);
+    }
+
+    lru_.push_front(path);
+    entries_[path] = {file, lru_.begin()};
+    total_bytes_ += bytes;
+}
+
+void FileCache::erase(const std::string& path) {
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+        return;
+    }
+    if (it->second.file->content) {
+        total_bytes_ -= it->second.file->size;
+    }
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+std::string FileCache::normalize_path(const std::string& request_path) {
+    size_t end = request_path.find_first_of("?#");
+    std::string raw = request_path.substr(0, end);
+    if (raw.empty() || raw[0] != '/') {
+        return "";
+    }
+
+    // Décodage des %XX
+    std::string decoded;
+    decoded.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '%') {
+            int high = i + 2 < raw.size() ? hex_value(raw[i + 1]) : -1;
+            int low = i + 2 < raw.size() ? hex_value(raw[i + 2]) : -1;
+            if (high < 0 || low < 0) {
+                return "";
+            }
+            decoded += static_cast<char>(high * 16 + low);
+            i += 2;
+        } else {
+            decoded += raw[i];
+        }
+    }
+
+    // Refuser les segments "..", les fichiers cachés et les octets nuls
+    std::string path;
+    size_t pos = 0;
+    while (pos < decoded.size()) {
+        size_t next = decoded.find('/', pos + 1);
+        std::string segment = decoded.substr(pos + 1, next == std::string::npos ? std::string::npos : next - pos - 1);
+        if (!segment.empty()) {
+            if (segment[0] == '.' || segment.find('\0') != std::string::npos) {
+                return "";
+            }
+            path += '/';
+            path += segment;
+        }
+        if (next == std::string::npos) {
+            break;
+        }
+        pos = next;
+    }
+
+    if (decoded.back() == '/') {
+        path += "/index.html";
+    }
+    return path;
+}
+
+std::string FileCache::content_type_for(const std::string& path) {
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+        std::string extension = path.substr(dot + 1);
+        for (char& c : extension) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        for (const MimeType& mime : MIME_TYPES) {
+            if (extension == mime.extension) {
+                return mime.type;
+            }
+        }
+    }
+    return "application/octet-stream";
+}
+
+std::string FileCache::http_date(time_t time) {
+    struct tm tm;
+    gmtime_r(&time, &tm);
+    char buffer[64];
+    std::strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    return buffer;
+}
+
+bool FileCache::parse_http_date(const std::string& value, time_t& time) {
+    struct tm tm;
+    std::memset(&tm, 0, sizeof(tm));
+    const char* end = strptime(value.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    if (!end || *end != '\0') {
+        return false;
+    }
+    time = timegm(&tm);
+    return true;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Descripteur de fichier ouvert en lecture, fermé avec le dernier segment
+ * de réponse qui le référence
+ */
+class FileDescriptor {
+public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    ~FileDescriptor();
+
+    // Non-copyable
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+/**
+ * Version d'un fichier servi: contenu partagé et validateurs calculés une
+ * seule fois au chargement (les réponses n'en prennent que des tranches).
+ * Un fichier trop gros pour le cache garde ses validateurs sans son
+ * contenu: les réponses le lisent alors sur disque, plage par plage.
+ */
+struct CachedFile {
+    std::shared_ptr<const std::string> content;     // nullptr: contenu lu sur disque
+    size_t size = 0;
+    std::string content_type;
+    std::string etag;               // Validateur fort, entre guillemets
+    time_t mtime = 0;
+    std::string last_modified;      // Date HTTP (IMF-fixdate)
+
+    // Identité de la version sur disque
+    dev_t device = 0;
+    ino_t inode = 0;
+    int64_t mtime_ns = 0;
+};
+
+/**
+ * Cache des fichiers statiques d'un répertoire racine
+ * Chaque requête fait un stat(): une entrée dont l'inode, la taille ou la
+ * date de modification a changé est rechargée avec un nouvel ETag, une
+ * entrée dont le fichier a disparu est retirée. Les contenus sont évincés
+ * du moins récemment servi au plus récent pour tenir le budget.
+ */
+class FileCache {
+public:
+    // Nombre maximal d'entrées, validateurs seuls compris
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    FileCache(const std::string& root, size_t max_bytes);
+
+    // Non-copyable
+    FileCache(const FileCache&) = delete;
+    FileCache& operator=(const FileCache&) = delete;
+
+    // Fichier correspondant à un chemin de requête; nullptr si absent, hors
+    // de la racine (cible des liens symboliques comprise) ou illisible. Sans
+    // contenu en cache, disk reçoit le fichier ouvert, dont l'identité
+    // correspond aux validateurs retournés
+    std::shared_ptr<const CachedFile> lookup(const std::string& request_path,
+                                             std::shared_ptr<const FileDescriptor>& disk);
+
+    // Octets de contenu actuellement conservés
+    size_t size_bytes();
+
+    static std::string content_type_for(const std::string& path);
+
+    // Dates HTTP (RFC 9110, IMF-fixdate)
+    static std::string http_date(time_t time);
+    static bool parse_http_date(const std::string& value, time_t& time);
+
+private:
+    struct Entry {
+        std::shared_ptr<const CachedFile> file;
+        std::list<std::string>::iterator lru;   // Position dans lru_
+    };
+
+    std::string root_;
+    size_t max_bytes_;
+    size_t total_bytes_ = 0;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                // Chemins, du plus récemment servi au plus ancien
+
+    // Chemin relatif nettoyé ("/a/b.css"), vide si refusé
+    static std::string normalize_path(const std::string& request_path);
+
+    // Chemin canonique (realpath) situé sous la racine
+    bool under_root(const std::string& resolved) const;
+
+    // La version décrite par st est-elle celle de l'entrée
+    static bool same_version(const CachedFile& file, const struct stat& st);
+
+    // Validateurs (et contenu si le budget le permet) de la version ouverte sur fd
+    std::shared_ptr<const CachedFile> load(const std::string& file_path, int fd, const struct stat& st);
+
+    // Sous mutex_
+    void store(const std::string& path, const std::shared_ptr<const CachedFile>& file);
+    void erase(const std::string& path);
+};
@@ -0,0 +1,530 @@
+#include "Hpack.h"
+#include <algorithm>
+
+namespace {
+
+struct HuffmanCode {
+    uint32_t code;
+    uint8_t bits;
+};
+
+// RFC 7541, annexe B (symboles 0 à 255, puis EOS)
+const HuffmanCode HUFFMAN_TABLE[257] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+    {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+    {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+    {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+    {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+    {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+    {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+    {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+    {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+    {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+    {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+    {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+    {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+    {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+    {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+    {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+    {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+    {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+    {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+    {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+    {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+    {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+    {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+    {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+    {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+    {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+    {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+    {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+    {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+    {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+    {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+    {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+    {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+    {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+    {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+    {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+    {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+    {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+    {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+    {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+    {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+    {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+    {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+    {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+    {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+    {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+    {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+    {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+    {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+    {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+    {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+    {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+    {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+    {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+    {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+    {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+    {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+    {0x3fffffff, 30},
+};
+
+constexpr int EOS = 256;
+constexpr int MAX_CODE_BITS = 30;
+
+// Le code de Huffman HPACK est canonique: pour chaque longueur, les codes
+// sont consécutifs, ce qui permet un décodage sans arbre
+struct HuffmanDecodeTable {
+    uint32_t first_code[MAX_CODE_BITS + 1] = {};
+    uint16_t count[MAX_CODE_BITS + 1] = {};
+    uint16_t offset[MAX_CODE_BITS + 1] = {};
+    uint16_t symbols[257] = {};
+
+    HuffmanDecodeTable() {
+        for (int sym = 0; sym <= EOS; ++sym) {
+            ++count[HUFFMAN_TABLE[sym].bits];
+        }
+        uint16_t next = 0;
+        for (int len = 1; len <= MAX_CODE_BITS; ++len) {
+            offset[len] = next;
+            next += count[len];
+        }
+        uint16_t fill[MAX_CODE_BITS + 1];
+        std::copy(std::begin(offset), std::end(offset), std::begin(fill));
+        for (int len = 1; len <= MAX_CODE_BITS; ++len) {
+            first_code[len] = UINT32_MAX;
+        }
+        for (int sym = 0; sym <= EOS; ++sym) {
+            const HuffmanCode& hc = HUFFMAN_TABLE[sym];
+            symbols[fill[hc.bits]++] = static_cast<uint16_t>(sym);
+            first_code[hc.bits] = std::min(first_code[hc.bits], hc.code);
+        }
+    }
+};
+
+const HuffmanDecodeTable& huffman_decode_table() {
+    static const HuffmanDecodeTable table;
+    return table;
+}
+
+const HpackHeader STATIC_TABLE[Hpack::STATIC_TABLE_SIZE] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+
+constexpr size_t ENTRY_OVERHEAD = 32;
+
+// Borne sur la taille décodée d'un bloc (protection contre les "bombes" HPACK)
+constexpr size_t MAX_HEADER_LIST_SIZE = 64 * 1024;
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Primitives
+
+void Hpack::encode_integer(uint32_t value, int prefix_bits, uint8_t first_byte, std::string& out) {
+    const uint32_t max_prefix = (1u << prefix_bits) - 1;
+    if (value < max_prefix) {
+        out += static_cast<char>(first_byte | value);
+        return;
+    }
+
+    out += static_cast<char>(first_byte | max_prefix);
+    value -= max_prefix;
+    while (value >= 128) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool Hpack::decode_integer(const uint8_t*& pos, const uint8_t* end, int prefix_bits, uint32_t& value) {
+    if (pos >= end) {
+        return false;
+    }
+
+    const uint32_t max_prefix = (1u << prefix_bits) - 1;
+    value = *pos++ & max_prefix;
+    if (value < max_prefix) {
+        return true;
+    }
+
+    int shift = 0;
+    while (pos < end) {
+        uint8_t byte = *pos++;
+        if (shift > 28) {
+            return false; // Dépassement
+        }
+        uint64_t add = static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (value + add > UINT32_MAX) {
+            return false;
+        }
+        value += static_cast<uint32_t>(add);
+        shift += 7;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Hpack::encode_string(const std::string& value, std::string& out) {
+    size_t huffman_len = huffman_encoded_length(value);
+    if (huffman_len < value.size()) {
+        encode_integer(static_cast<uint32_t>(huffman_len), 7, 0x80, out);
+        huffman_encode(value, out);
+    } else {
+        encode_integer(static_cast<uint32_t>(value.size()), 7, 0x00, out);
+        out += value;
+    }
+}
+
+bool Hpack::decode_string(const uint8_t*& pos, const uint8_t* end, std::string& value) {
+    if (pos >= end) {
+        return false;
+    }
+
+    bool huffman = (*pos & 0x80) != 0;
+    uint32_t len;
+    if (!decode_integer(pos, end, 7, len) || len > static_cast<size_t>(end - pos)) {
+        return false;
+    }
+
+    value.clear();
+    bool ok = true;
+    if (huffman) {
+        ok = huffman_decode(pos, len, value);
+    } else {
+        value.assign(reinterpret_cast<const char*>(pos), len);
+    }
+    pos += len;
+    return ok;
+}
+
+size_t Hpack::huffman_encoded_length(const std::string& value) {
+    size_t bits = 0;
+    for (unsigned char c : value) {
+        bits += HUFFMAN_TABLE[c].bits;
+    }
+    return (bits + 7) / 8;
+}
+
+void Hpack::huffman_encode(const std::string& value, std::string& out) {
+    uint64_t buffer = 0;
+    int buffered_bits = 0;
+
+    for (unsigned char c : value) {
+        const HuffmanCode& hc = HUFFMAN_TABLE[c];
+        buffer = (buffer << hc.bits) | hc.code;
+        buffered_bits += hc.bits;
+        while (buffered_bits >= 8) {
+            buffered_bits -= 8;
+            out += static_cast<char>(buffer >> buffered_bits);
+        }
+    }
+
+    // Bourrage avec le préfixe de EOS (bits à 1)
+    if (buffered_bits > 0) {
+        buffer = (buffer << (8 - buffered_bits)) | (0xffu >> buffered_bits);
+        out += static_cast<char>(buffer);
+    }
+}
+
+bool Hpack::huffman_decode(const uint8_t* data, size_t len, std::string& out) {
+    const HuffmanDecodeTable& table = huffman_decode_table();
+    uint32_t code = 0;
+    int code_bits = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((data[i] >> bit) & 1);
+            ++code_bits;
+
+            if (table.count[code_bits] > 0 && code >= table.first_code[code_bits] &&
+                code - table.first_code[code_bits] < table.count[code_bits]) {
+                uint16_t sym = table.symbols[table.offset[code_bits] + (code - table.first_code[code_bits])];
+                if (sym == EOS) {
+                    return false; // EOS explicite interdit
+                }
+                out += static_cast<char>(sym);
+                code = 0;
+                code_bits = 0;
+            } else if (code_bits >= MAX_CODE_BITS) {
+                return false;
+            }
+        }
+    }
+
+    // Bourrage: au plus 7 bits, tous à 1
+    return code_bits < 8 && code == (1u << code_bits) - 1;
+}
+
+const HpackHeader* Hpack::static_entry(size_t index) {
+    if (index == 0 || index > STATIC_TABLE_SIZE) {
+        return nullptr;
+    }
+    return &STATIC_TABLE[index - 1];
+}
+
+// ---------------------------------------------------------------------------
+// Table dynamique
+
+void HpackDynamicTable::add(const std::string& name, const std::string& value) {
+    size_t entry_size = name.size() + value.size() + ENTRY_OVERHEAD;
+    if (entry_size > max_size_) {
+        // Une entrée plus grande que la table la vide sans être ajoutée
+        entries_.clear();
+        size_ = 0;
+        return;
+    }
+
+    evict(entry_size);
+    entries_.emplace_front(name, value);
+    size_ += entry_size;
+}
+
+void HpackDynamicTable::set_max_size(size_t max_size) {
+    max_size_ = max_size;
+    evict(0);
+}
+
+const HpackHeader* HpackDynamicTable::get(size_t index) const {
+    return index < entries_.size() ? &entries_[index] : nullptr;
+}
+
+void HpackDynamicTable::evict(size_t required) {
+    while (!entries_.empty() && size_ + required > max_size_) {
+        const HpackHeader& last = entries_.back();
+        size_ -= last.first.size() + last.second.size() + ENTRY_OVERHEAD;
+        entries_.pop_back();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Décodeur
+
+HpackDecoder::HpackDecoder(size_t settings_max_size)
+    : table_(settings_max_size), settings_max_size_(settings_max_size) {
+}
+
+bool HpackDecoder::lookup(uint32_t index, HpackHeader& header) const {
+    if (index == 0) {
+        return false;
+    }
+    if (index <= Hpack::STATIC_TABLE_SIZE) {
+        header = *Hpack::static_entry(index);
+        return true;
+    }
+    const HpackHeader* entry = table_.get(index - Hpack::STATIC_TABLE_SIZE - 1);
+    if (!entry) {
+        return false;
+    }
+    header = *entry;
+    return true;
+}
+
+bool HpackDecoder::decode(const uint8_t* data, size_t len, HpackHeaderList& headers) {
+    const uint8_t* pos = data;
+    const uint8_t* end = data + len;
+    bool header_seen = false;
+    size_t list_size = 0;
+
+    while (pos < end) {
+        uint8_t byte = *pos;
+        HpackHeader header;
+        uint32_t index;
+
+        if (byte & 0x80) {
+            // Champ indexé
+            if (!Hpack::decode_integer(pos, end, 7, index) || !lookup(index, header)) {
+                return false;
+            }
+        } else if ((byte & 0xe0) == 0x20) {
+            // Mise à jour de la taille de la table: seulement en début de bloc
+            uint32_t size;
+            if (header_seen || !Hpack::decode_integer(pos, end, 5, size) || size > settings_max_size_) {
+                return false;
+            }
+            table_.set_max_size(size);
+            continue;
+        } else {
+            // Littéral: avec indexation (01), sans indexation (0000) ou jamais indexé (0001)
+            bool incremental = (byte & 0xc0) == 0x40;
+            int prefix_bits = incremental ? 6 : 4;
+            if (!Hpack::decode_integer(pos, end, prefix_bits, index)) {
+                return false;
+            }
+            if (index > 0) {
+                if (!lookup(index, header)) {
+                    return false;
+                }
+            } else if (!Hpack::decode_string(pos, end, header.first)) {
+                return false;
+            }
+            if (!Hpack::decode_string(pos, end, header.second)) {
+                return false;
+            }
+            if (incremental) {
+                table_.add(header.first, header.second);
+            }
+        }
+
+        header_seen = true;
+        list_size += header.first.size() + header.second.size() + ENTRY_OVERHEAD;
+        if (list_size > MAX_HEADER_LIST_SIZE) {
+            return false;
+        }
+        headers.push_back(std::move(header));
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Encodeur
+
+void HpackEncoder::set_max_table_size(size_t max_size) {
+    // Jamais plus que la taille par défaut: au-delà, le gain est négligeable
+    pending_max_size_ = std::min<size_t>(max_size, 4096);
+    if (pending_max_size_ != table_.max_size()) {
+        size_update_pending_ = true;
+    }
+}
+
+bool HpackEncoder::should_index(const std::string& name) {
+    return name != "content-length" && name != "content-range" && name != "date" &&
+           name != "etag" && name != "last-modified" && name != "set-cookie";
+}
+
+size_t HpackEncoder::find(const std::string& name, const std::string& value, bool& name_only) const {
+    size_t name_match = 0;
+
+    for (size_t i = 1; i <= Hpack::STATIC_TABLE_SIZE; ++i) {
+        const HpackHeader* entry = Hpack::static_entry(i);
+        if (entry->first == name) {
+            if (entry->second == value) {
+                name_only = false;
+                return i;
+            }
+            if (!name_match) {
+                name_match = i;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < table_.count(); ++i) {
+        const HpackHeader* entry = table_.get(i);
+        if (entry->first == name) {
+            if (entry->second == value) {
+                name_only = false;
+                return Hpack::STATIC_TABLE_SIZE + 1 + i;
+            }
+            if (!name_match) {
+                name_match = Hpack::STATIC_TABLE_SIZE + 1 + i;
+            }
+        }
+    }
+
+    name_only = true;
+    return name_match;
+}
+
+void HpackEncoder::encode(const HpackHeaderList& headers, std::string& out) {
+    if (size_update_pending_) {
+        table_.set_max_size(pending_max_size_);
+        Hpack::encode_integer(static_cast<uint32_t>(pending_max_size_), 5, 0x20, out);
+        size_update_pending_ = false;
+    }
+
+    for (const auto& header : headers) {
+        bool name_only = false;
+        size_t index = find(header.first, header.second, name_only);
+
+        if (index > 0 && !name_only) {
+            Hpack::encode_integer(static_cast<uint32_t>(index), 7, 0x80, out);
+            continue;
+        }
+
+        bool indexing = should_index(header.first);
+        if (indexing) {
+            Hpack::encode_integer(static_cast<uint32_t>(index), 6, 0x40, out);
+        } else {
+            Hpack::encode_integer(static_cast<uint32_t>(index), 4, 0x00, out);
+        }
+        if (index == 0) {
+            Hpack::encode_string(header.first, out);
+        }
+        Hpack::encode_string(header.second, out);
+
+        if (indexing) {
+            table_.add(header.first, header.second);
+        }
+    }
+}
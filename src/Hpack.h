@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Compression d'en-têtes HPACK (RFC 7541) pour HTTP/2
+ */
+using HpackHeader = std::pair<std::string, std::string>;
+using HpackHeaderList = std::vector<HpackHeader>;
+
+/**
+ * Primitives HPACK: entiers à préfixe, chaînes littérales, Huffman, table statique
+ */
+class Hpack {
+public:
+    static void encode_integer(uint32_t value, int prefix_bits, uint8_t first_byte, std::string& out);
+    static bool decode_integer(const uint8_t*& pos, const uint8_t* end, int prefix_bits, uint32_t& value);
+
+    // Chaîne littérale, codée en Huffman si c'est plus court
+    static void encode_string(const std::string& value, std::string& out);
+    static bool decode_string(const uint8_t*& pos, const uint8_t* end, std::string& value);
+
+    static void huffman_encode(const std::string& value, std::string& out);
+    static size_t huffman_encoded_length(const std::string& value);
+    static bool huffman_decode(const uint8_t* data, size_t len, std::string& out);
+
+    // Table statique (index 1 à 61), nullptr si hors limites
+    static const HpackHeader* static_entry(size_t index);
+    static constexpr size_t STATIC_TABLE_SIZE = 61;
+};
+
+/**
+ * Table dynamique (FIFO, taille comptée selon la RFC: nom + valeur + 32)
+ */
+class HpackDynamicTable {
+public:
+    explicit HpackDynamicTable(size_t max_size = 4096) : max_size_(max_size) {}
+
+    void add(const std::string& name, const std::string& value);
+    void set_max_size(size_t max_size);
+
+    // Index 0 = entrée la plus récente
+    const HpackHeader* get(size_t index) const;
+    size_t count() const { return entries_.size(); }
+    size_t max_size() const { return max_size_; }
+
+private:
+    std::deque<HpackHeader> entries_;
+    size_t size_ = 0;
+    size_t max_size_;
+
+    void evict(size_t required);
+};
+
+/**
+ * Décodeur d'un côté de la connexion (requêtes du client)
+ */
+class HpackDecoder {
+public:
+    // settings_max_size: valeur annoncée dans SETTINGS_HEADER_TABLE_SIZE
+    explicit HpackDecoder(size_t settings_max_size = 4096);
+
+    // Décoder un bloc d'en-têtes complet; false = COMPRESSION_ERROR
+    bool decode(const uint8_t* data, size_t len, HpackHeaderList& headers);
+
+private:
+    HpackDynamicTable table_;
+    size_t settings_max_size_;
+
+    bool lookup(uint32_t index, HpackHeader& header) const;
+};
+
+/**
+ * Encodeur des réponses: les en-têtes répétés (server, content-type...)
+ * sont indexés dans la table dynamique et réémis sur un seul octet
+ */
+class HpackEncoder {
+public:
+    HpackEncoder() = default;
+
+    // Taille maximale annoncée par le pair (SETTINGS_HEADER_TABLE_SIZE)
+    void set_max_table_size(size_t max_size);
+
+    void encode(const HpackHeaderList& headers, std::string& out);
+
+private:
+    HpackDynamicTable table_;
+    size_t pending_max_size_ = 4096;
+    bool size_update_pending_ = false;
+
+    // Index (> 0) de l'entrée trouvée, 0 sinon; name_only si seul le nom correspond
+    size_t find(const std::string& name, const std::string& value, bool& name_only) const;
+
+    // Valeurs propres à chaque réponse: inutile de les indexer
+    static bool should_index(const std::string& name);
+};
@@ -0,0 +1,743 @@
+#include "Http2Session.h"
+#include "Base64.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+namespace {
+
+constexpr size_t FRAME_HEADER_LEN = 9;
+
+// Flags
+constexpr uint8_t FLAG_END_STREAM = 0x1;
+constexpr uint8_t FLAG_ACK = 0x1;
+constexpr uint8_t FLAG_END_HEADERS = 0x4;
+constexpr uint8_t FLAG_PADDED = 0x8;
+constexpr uint8_t FLAG_PRIORITY = 0x20;
+
+// Identifiants de SETTINGS
+constexpr uint16_t SETTINGS_HEADER_TABLE_SIZE = 0x1;
+constexpr uint16_t SETTINGS_ENABLE_PUSH = 0x2;
+constexpr uint16_t SETTINGS_MAX_CONCURRENT_STREAMS = 0x3;
+constexpr uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4;
+constexpr uint16_t SETTINGS_MAX_FRAME_SIZE = 0x5;
+
+// Valeurs annoncées par le serveur
+constexpr uint32_t LOCAL_MAX_CONCURRENT_STREAMS = 100;
+constexpr uint32_t LOCAL_INITIAL_WINDOW = 1 << 20;
+constexpr uint32_t LOCAL_CONNECTION_WINDOW = 16 << 20;
+constexpr uint32_t LOCAL_MAX_FRAME_SIZE = 16384;
+constexpr uint32_t DEFAULT_WINDOW = 65535;
+constexpr uint32_t MAX_WINDOW = 0x7fffffff;
+
+// Borne sur les blocs d'en-têtes et les corps de requêtes en cours
+constexpr size_t MAX_HEADER_BLOCK = 64 * 1024;
+constexpr size_t MAX_REQUEST_BODY = 1 << 20;
+
+uint32_t read_u32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void append_u32(std::string& out, uint32_t value) {
+    out += static_cast<char>(value >> 24);
+    out += static_cast<char>(value >> 16);
+    out += static_cast<char>(value >> 8);
+    out += static_cast<char>(value);
+}
+
+void append_setting(std::string& out, uint16_t id, uint32_t value) {
+    out += static_cast<char>(id >> 8);
+    out += static_cast<char>(id);
+    append_u32(out, value);
+}
+
+// Retirer le bourrage d'une trame PADDED; false si la longueur est invalide
+bool strip_padding(uint8_t flags, const uint8_t*& payload, uint32_t& length) {
+    if (!(flags & FLAG_PADDED)) {
+        return true;
+    }
+    if (length < 1) {
+        return false;
+    }
+    uint8_t pad = payload[0];
+    if (pad >= length) {
+        return false;
+    }
+    payload += 1;
+    length -= 1 + pad;
+    return true;
+}
+
+} // namespace
+
+Http2Session::Http2Session(Handler handler)
+    : handler_(std::move(handler)), decoder_(4096) {
+}
+
+bool Http2Session::matches_preface(const char* data, size_t len) {
+    return std::memcmp(data, PREFACE, std::min(len, PREFACE_LEN)) == 0;
+}
+
+void Http2Session::start(std::string& out) {
+    std::string payload;
+    append_setting(payload, SETTINGS_MAX_CONCURRENT_STREAMS, LOCAL_MAX_CONCURRENT_STREAMS);
+    append_setting(payload, SETTINGS_INITIAL_WINDOW_SIZE, LOCAL_INITIAL_WINDOW);
+    append_setting(payload, SETTINGS_ENABLE_PUSH, 0);
+
+    write_frame_header(out, static_cast<uint32_t>(payload.size()), SETTINGS, 0, 0);
+    out += payload;
+
+    // La fenêtre de connexion ne se règle que par WINDOW_UPDATE
+    write_window_update(out, 0, LOCAL_CONNECTION_WINDOW - DEFAULT_WINDOW);
+    conn_recv_window_ = LOCAL_CONNECTION_WINDOW;
+}
+
+bool Http2Session::start_upgraded(const HttpRequest& request, const std::string& http2_settings,
+                                  std::string& out) {
+    std::string payload;
+    ErrorCode error = NO_ERROR;
+    if (!Base64::decode(http2_settings, payload) ||
+        !apply_settings(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), error)) {
+        return false;
+    }
+
+    start(out);
+
+    // La requête d'origine devient le flux 1, déjà à moitié fermé côté client
+    Stream& stream = streams_[1];
+    stream.request = request;
+    stream.request.version = "HTTP/2.0";
+    stream.request.keep_alive = true;
+    stream.remote_closed = true;
+    stream.send_window = peer_initial_window_;
+    last_stream_id_ = 1;
+
+    dispatch(1, out);
+    return true;
+}
+
+bool Http2Session::on_data(const char* data, size_t len, std::string& out) {
+    if (goaway_sent_) {
+        return false;
+    }
+
+    input_.append(data, len);
+    size_t offset = 0;
+
+    if (!preface_received_) {
+        if (input_.size() < PREFACE_LEN) {
+            return matches_preface(input_.data(), input_.size()) || connection_error(PROTOCOL_ERROR, out);
+        }
+        if (!matches_preface(input_.data(), PREFACE_LEN)) {
+            return connection_error(PROTOCOL_ERROR, out);
+        }
+        preface_received_ = true;
+        offset = PREFACE_LEN;
+    }
+
+    bool ok = true;
+    while (ok && input_.size() - offset >= FRAME_HEADER_LEN) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(input_.data()) + offset;
+        FrameHeader header;
+        header.length = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+        header.type = p[3];
+        header.flags = p[4];
+        header.stream_id = read_u32(p + 5) & 0x7fffffff;
+
+        if (header.length > LOCAL_MAX_FRAME_SIZE) {
+            ok = connection_error(FRAME_SIZE_ERROR, out);
+            break;
+        }
+        if (input_.size() - offset < FRAME_HEADER_LEN + header.length) {
+            break; // Trame incomplète
+        }
+
+        ok = process_frame(header, p + FRAME_HEADER_LEN, out);
+        offset += FRAME_HEADER_LEN + header.length;
+    }
+
+    input_.erase(0, offset);
+
+    // Rendre le crédit de la connexion par lots
+    if (ok && conn_recv_unacked_ >= LOCAL_CONNECTION_WINDOW / 2) {
+        write_window_update(out, 0, conn_recv_unacked_);
+        conn_recv_window_ += conn_recv_unacked_;
+        conn_recv_unacked_ = 0;
+    }
+
+    return ok;
+}
+
+void Http2Session::resume(std::string& out) {
+    output_limited_ = false;
+    flush_all(out);
+}
+
+bool Http2Session::finished() const {
+    if (goaway_sent_) {
+        return true;
+    }
+    if (!goaway_received_) {
+        return false;
+    }
+    for (const auto& entry : streams_) {
+        if (entry.second.pending_offset < entry.second.pending.size() || entry.second.producing) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Http2Session::process_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    // Un bloc d'en-têtes doit être terminé avant toute autre trame
+    if (continuation_stream_ != 0 &&
+        (header.type != CONTINUATION || header.stream_id != continuation_stream_)) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+
+    switch (header.type) {
+        case DATA:
+            return on_data_frame(header, payload, out);
+
+        case HEADERS:
+            return on_headers_frame(header, payload, out);
+
+        case CONTINUATION:
+            return on_continuation_frame(header, payload, out);
+
+        case PRIORITY:
+            if (header.stream_id == 0) {
+                return connection_error(PROTOCOL_ERROR, out);
+            }
+            if (header.length != 5) {
+                reset_stream(header.stream_id, FRAME_SIZE_ERROR, out);
+            }
+            return true; // Priorités ignorées: réponses traitées dans l'ordre
+
+        case RST_STREAM:
+            if (header.stream_id == 0 || header.stream_id > last_stream_id_) {
+                return connection_error(PROTOCOL_ERROR, out);
+            }
+            if (header.length != 4) {
+                return connection_error(FRAME_SIZE_ERROR, out);
+            }
+            streams_.erase(header.stream_id);
+            return true;
+
+        case SETTINGS:
+            return on_settings_frame(header, payload, out);
+
+        case PUSH_PROMISE:
+            // Un client ne peut pas pousser de flux
+            return connection_error(PROTOCOL_ERROR, out);
+
+        case PING:
+            if (header.stream_id != 0) {
+                return connection_error(PROTOCOL_ERROR, out);
+            }
+            if (header.length != 8) {
+                return connection_error(FRAME_SIZE_ERROR, out);
+            }
+            if (!(header.flags & FLAG_ACK)) {
+                write_frame_header(out, 8, PING, FLAG_ACK, 0);
+                out.append(reinterpret_cast<const char*>(payload), 8);
+            }
+            return true;
+
+        case GOAWAY:
+            if (header.stream_id != 0) {
+                return connection_error(PROTOCOL_ERROR, out);
+            }
+            goaway_received_ = true;
+            return true;
+
+        case WINDOW_UPDATE:
+            return on_window_update_frame(header, payload, out);
+
+        default:
+            // Types inconnus ignorés (RFC 7540, section 4.1)
+            return true;
+    }
+}
+
+bool Http2Session::on_data_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    if (header.stream_id == 0) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+
+    // Le bourrage compte dans le contrôle de flux; au-delà de la fenêtre annoncée, le pair
+    // ignore le contrôle de flux (RFC 7540, section 6.9.1)
+    if (header.length > conn_recv_window_) {
+        return connection_error(FLOW_CONTROL_ERROR, out);
+    }
+    conn_recv_window_ -= header.length;
+    conn_recv_unacked_ += header.length;
+
+    uint32_t length = header.length;
+    if (!strip_padding(header.flags, payload, length)) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+
+    auto it = streams_.find(header.stream_id);
+    if (it == streams_.end() || it->second.remote_closed) {
+        if (header.stream_id > last_stream_id_) {
+            return connection_error(PROTOCOL_ERROR, out);
+        }
+        reset_stream(header.stream_id, STREAM_CLOSED, out);
+        return true;
+    }
+
+    Stream& stream = it->second;
+    if (header.length > stream.recv_window) {
+        reset_stream(header.stream_id, FLOW_CONTROL_ERROR, out);
+        return true;
+    }
+    stream.recv_window -= header.length;
+    if (stream.request.body.size() + length > MAX_REQUEST_BODY) {
+        reset_stream(header.stream_id, CANCEL, out);
+        return true;
+    }
+    stream.request.body.append(reinterpret_cast<const char*>(payload), length);
+
+    if (header.flags & FLAG_END_STREAM) {
+        stream.remote_closed = true;
+        dispatch(header.stream_id, out);
+    } else {
+        stream.recv_unacked += header.length;
+        if (stream.recv_unacked >= LOCAL_INITIAL_WINDOW / 2) {
+            write_window_update(out, header.stream_id, stream.recv_unacked);
+            stream.recv_window += stream.recv_unacked;
+            stream.recv_unacked = 0;
+        }
+    }
+    return true;
+}
+
+bool Http2Session::on_headers_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    if (header.stream_id == 0) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+
+    uint32_t length = header.length;
+    if (!strip_padding(header.flags, payload, length)) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+    if (header.flags & FLAG_PRIORITY) {
+        if (length < 5) {
+            return connection_error(FRAME_SIZE_ERROR, out);
+        }
+        payload += 5;
+        length -= 5;
+    }
+
+    header_block_.assign(reinterpret_cast<const char*>(payload), length);
+    continuation_end_stream_ = (header.flags & FLAG_END_STREAM) != 0;
+
+    if (!(header.flags & FLAG_END_HEADERS)) {
+        continuation_stream_ = header.stream_id;
+        return true;
+    }
+    return on_header_block_complete(header.stream_id, continuation_end_stream_, out);
+}
+
+bool Http2Session::on_continuation_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    if (continuation_stream_ == 0 || header.stream_id != continuation_stream_) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+    if (header_block_.size() + header.length > MAX_HEADER_BLOCK) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+
+    header_block_.append(reinterpret_cast<const char*>(payload), header.length);
+    if (!(header.flags & FLAG_END_HEADERS)) {
+        return true;
+    }
+
+    continuation_stream_ = 0;
+    return on_header_block_complete(header.stream_id, continuation_end_stream_, out);
+}
+
+bool Http2Session::on_header_block_complete(uint32_t stream_id, bool end_stream, std::string& out) {
+    // Décoder même si le flux est refusé: l'état HPACK doit rester synchronisé
+    HpackHeaderList headers;
+    bool decoded = decoder_.decode(reinterpret_cast<const uint8_t*>(header_block_.data()),
+                                   header_block_.size(), headers);
+    header_block_.clear();
+    if (!decoded) {
+        return connection_error(COMPRESSION_ERROR, out);
+    }
+
+    if (streams_.count(stream_id)) {
+        // Trailers: seuls des en-têtes de fin de flux sont acceptés
+        Stream& stream = streams_[stream_id];
+        if (stream.remote_closed || !end_stream) {
+            return connection_error(PROTOCOL_ERROR, out);
+        }
+        stream.remote_closed = true;
+        dispatch(stream_id, out);
+        return true;
+    }
+
+    // Nouveau flux: identifiant impair et croissant
+    if (stream_id % 2 == 0 || stream_id <= last_stream_id_) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+    last_stream_id_ = stream_id;
+
+    if (goaway_received_) {
+        reset_stream(stream_id, REFUSED_STREAM, out);
+        return true;
+    }
+    if (streams_.size() >= LOCAL_MAX_CONCURRENT_STREAMS) {
+        reset_stream(stream_id, REFUSED_STREAM, out);
+        return true;
+    }
+
+    Stream stream;
+    if (!build_request(headers, stream.request)) {
+        reset_stream(stream_id, PROTOCOL_ERROR, out);
+        return true;
+    }
+    stream.send_window = peer_initial_window_;
+    stream.recv_window = LOCAL_INITIAL_WINDOW;
+    stream.remote_closed = end_stream;
+    streams_.emplace(stream_id, std::move(stream));
+
+    if (end_stream) {
+        dispatch(stream_id, out);
+    }
+    return true;
+}
+
+bool Http2Session::on_settings_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    if (header.stream_id != 0) {
+        return connection_error(PROTOCOL_ERROR, out);
+    }
+    if (header.flags & FLAG_ACK) {
+        return header.length == 0 || connection_error(FRAME_SIZE_ERROR, out);
+    }
+
+    ErrorCode error = NO_ERROR;
+    if (!apply_settings(payload, header.length, error)) {
+        return connection_error(error, out);
+    }
+
+    write_frame_header(out, 0, SETTINGS, FLAG_ACK, 0);
+
+    // Une nouvelle fenêtre initiale peut débloquer des réponses en attente
+    flush_all(out);
+    return true;
+}
+
+bool Http2Session::on_window_update_frame(const FrameHeader& header, const uint8_t* payload, std::string& out) {
+    if (header.length != 4) {
+        return connection_error(FRAME_SIZE_ERROR, out);
+    }
+
+    uint32_t increment = read_u32(payload) & 0x7fffffff;
+
+    if (header.stream_id == 0) {
+        if (increment == 0) {
+            return connection_error(PROTOCOL_ERROR, out);
+        }
+        conn_send_window_ += increment;
+        if (conn_send_window_ > MAX_WINDOW) {
+            return connection_error(FLOW_CONTROL_ERROR, out);
+        }
+        flush_all(out);
+        return true;
+    }
+
+    auto it = streams_.find(header.stream_id);
+    if (it == streams_.end()) {
+        if (header.stream_id > last_stream_id_) {
+            return connection_error(PROTOCOL_ERROR, out);
+        }
+        return true; // Flux déjà fermé
+    }
+    if (increment == 0) {
+        reset_stream(header.stream_id, PROTOCOL_ERROR, out);
+        return true;
+    }
+
+    it->second.send_window += increment;
+    if (it->second.send_window > MAX_WINDOW) {
+        reset_stream(header.stream_id, FLOW_CONTROL_ERROR, out);
+        return true;
+    }
+    flush_stream(header.stream_id, out);
+    return true;
+}
+
+bool Http2Session::apply_settings(const uint8_t* payload, size_t len, ErrorCode& error) {
+    if (len % 6 != 0) {
+        error = FRAME_SIZE_ERROR;
+        return false;
+    }
+
+    for (size_t i = 0; i < len; i += 6) {
+        uint16_t id = static_cast<uint16_t>((payload[i] << 8) | payload[i + 1]);
+        uint32_t value = read_u32(payload + i + 2);
+
+        switch (id) {
+            case SETTINGS_HEADER_TABLE_SIZE:
+                encoder_.set_max_table_size(value);
+                break;
+
+            case SETTINGS_ENABLE_PUSH:
+                if (value > 1) {
+                    error = PROTOCOL_ERROR;
+                    return false;
+                }
+                break;
+
+            case SETTINGS_INITIAL_WINDOW_SIZE: {
+                if (value > MAX_WINDOW) {
+                    error = FLOW_CONTROL_ERROR;
+                    return false;
+                }
+                // Ajuster toutes les fenêtres d'envoi ouvertes de la différence
+                int64_t delta = static_cast<int64_t>(value) - peer_initial_window_;
+                for (auto& entry : streams_) {
+                    entry.second.send_window += delta;
+                    if (entry.second.send_window > MAX_WINDOW) {
+                        error = FLOW_CONTROL_ERROR;
+                        return false;
+                    }
+                }
+                peer_initial_window_ = value;
+                break;
+            }
+
+            case SETTINGS_MAX_FRAME_SIZE:
+                if (value < 16384 || value > 0xffffff) {
+                    error = PROTOCOL_ERROR;
+                    return false;
+                }
+                peer_max_frame_size_ = value;
+                break;
+
+            default:
+                // MAX_CONCURRENT_STREAMS (le serveur n'ouvre pas de flux), autres ignorés
+                break;
+        }
+    }
+    return true;
+}
+
+bool Http2Session::build_request(const HpackHeaderList& headers, HttpRequest& request) const {
+    bool regular_seen = false;
+    std::string scheme;
+
+    for (const auto& header : headers) {
+        const std::string& name = header.first;
+
+        // Noms en minuscules obligatoires
+        if (std::any_of(name.begin(), name.end(), [](char c) { return c >= 'A' && c <= 'Z'; })) {
+            return false;
+        }
+
+        if (!name.empty() && name[0] == ':') {
+            if (regular_seen) {
+                return false; // Pseudo-en-têtes uniquement en tête de bloc
+            }
+            if (name == ":method") {
+                request.method = header.second;
+            } else if (name == ":path") {
+                request.path = header.second;
+            } else if (name == ":scheme") {
+                scheme = header.second;
+            } else if (name == ":authority") {
+                request.headers["host"] = header.second;
+            } else {
+                return false;
+            }
+            continue;
+        }
+
+        regular_seen = true;
+        if (name == "connection" || name == "keep-alive" || name == "upgrade" ||
+            name == "transfer-encoding" || name == "proxy-connection") {
+            return false; // En-têtes propres à HTTP/1.x interdits
+        }
+
+        auto it = request.headers.find(name);
+        if (it != request.headers.end() && name == "cookie") {
+            it->second += "; " + header.second;
+        } else if (it != request.headers.end() && name != "host") {
+            it->second += ", " + header.second;
+        } else {
+            request.headers[name] = header.second;
+        }
+    }
+
+    if (request.method.empty() || request.path.empty() || scheme.empty()) {
+        return false;
+    }
+
+    request.version = "HTTP/2.0";
+    request.keep_alive = true;
+    return true;
+}
+
+void Http2Session::dispatch(uint32_t stream_id, std::string& out) {
+    Stream& stream = streams_[stream_id];
+    std::string body;
+    HpackHeaderList extra;
+    StreamedResponse::Producer produce;
+    HttpResponse::StatusCode status;
+
+    try {
+        status = handler_(stream.request, body, extra, produce);
+    } catch (const std::exception&) {
+        reset_stream(stream_id, INTERNAL_ERROR, out);
+        return;
+    }
+
+    HpackHeaderList headers = {
+        {":status", std::to_string(static_cast<int>(status))},
+        {"server", HttpResponse::SERVER_NAME},
+    };
+    auto has_header = [&extra](const char* name) {
+        return std::any_of(extra.begin(), extra.end(),
+                           [name](const HpackHeader& header) { return header.first == name; });
+    };
+    if (!has_header("content-type") && status != HttpResponse::NOT_MODIFIED) {
+        headers.emplace_back("content-type", HttpResponse::DEFAULT_CONTENT_TYPE);
+    }
+    if (!has_header("content-length") && !produce && status != HttpResponse::NOT_MODIFIED) {
+        headers.emplace_back("content-length", std::to_string(body.size()));
+    }
+    headers.insert(headers.end(), extra.begin(), extra.end());
+    std::string block;
+    encoder_.encode(headers, block);
+
+    // En-têtes: HEADERS puis CONTINUATION si le bloc dépasse la taille de trame
+    bool end_stream = body.empty() && !produce;
+    size_t offset = 0;
+    do {
+        size_t chunk = std::min<size_t>(block.size() - offset, peer_max_frame_size_);
+        bool first = offset == 0;
+        bool last = offset + chunk == block.size();
+        uint8_t flags = (last ? FLAG_END_HEADERS : 0) | (first && end_stream ? FLAG_END_STREAM : 0);
+        write_frame_header(out, static_cast<uint32_t>(chunk), first ? HEADERS : CONTINUATION, flags, stream_id);
+        out.append(block, offset, chunk);
+        offset += chunk;
+    } while (offset < block.size());
+
+    stream.responded = true;
+    stream.pending = std::move(body);
+    stream.pending_offset = 0;
+    stream.producing = static_cast<bool>(produce);
+    stream.produce = std::move(produce);
+    flush_stream(stream_id, out);
+}
+
+void Http2Session::flush_stream(uint32_t stream_id, std::string& out) {
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end() || !it->second.responded) {
+        return;
+    }
+
+    Stream& stream = it->second;
+    while (stream.pending_offset < stream.pending.size() || stream.producing) {
+        if (out.size() >= MAX_OUTPUT) {
+            output_limited_ = true;
+            return; // Attendre que l'appelant ait vidé la sortie
+        }
+        int64_t window = std::min(conn_send_window_, stream.send_window);
+        if (window <= 0) {
+            return; // Attendre un WINDOW_UPDATE
+        }
+
+        // Produire seulement ce que la fenêtre permet d'envoyer: un pair qui ne lit pas
+        // arrête le producteur au lieu de faire grossir le buffer
+        if (stream.pending_offset == stream.pending.size()) {
+            stream.pending.clear();
+            stream.pending_offset = 0;
+            try {
+                stream.producing = stream.produce(stream.pending);
+            } catch (const std::exception&) {
+                reset_stream(stream_id, INTERNAL_ERROR, out);
+                return;
+            }
+            if (!stream.producing) {
+                stream.produce = nullptr;
+                if (stream.pending.empty()) {
+                    write_frame_header(out, 0, DATA, FLAG_END_STREAM, stream_id);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        size_t remaining = stream.pending.size() - stream.pending_offset;
+        size_t chunk = std::min<size_t>({remaining, static_cast<size_t>(window), peer_max_frame_size_});
+        bool last = chunk == remaining && !stream.producing;
+
+        write_frame_header(out, static_cast<uint32_t>(chunk), DATA, last ? FLAG_END_STREAM : 0, stream_id);
+        out.append(stream.pending, stream.pending_offset, chunk);
+
+        stream.pending_offset += chunk;
+        stream.send_window -= static_cast<int64_t>(chunk);
+        conn_send_window_ -= static_cast<int64_t>(chunk);
+    }
+
+    close_stream_if_done(stream_id);
+}
+
+void Http2Session::flush_all(std::string& out) {
+    std::vector<uint32_t> ids;
+    for (const auto& entry : streams_) {
+        if (entry.second.responded) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (uint32_t id : ids) {
+        if (conn_send_window_ <= 0 || output_limited_) {
+            return;
+        }
+        flush_stream(id, out);
+    }
+}
+
+void Http2Session::close_stream_if_done(uint32_t stream_id) {
+    auto it = streams_.find(stream_id);
+    if (it != streams_.end() && it->second.remote_closed && it->second.responded &&
+        it->second.pending_offset == it->second.pending.size() && !it->second.producing) {
+        streams_.erase(it);
+    }
+}
+
+bool Http2Session::connection_error(ErrorCode code, std::string& out) {
+    if (!goaway_sent_) {
+        write_frame_header(out, 8, GOAWAY, 0, 0);
+        append_u32(out, last_stream_id_);
+        append_u32(out, code);
+        goaway_sent_ = true;
+    }
+    return false;
+}
+
+void Http2Session::reset_stream(uint32_t stream_id, ErrorCode code, std::string& out) {
+    write_frame_header(out, 4, RST_STREAM, 0, stream_id);
+    append_u32(out, code);
+    streams_.erase(stream_id);
+}
+
+void Http2Session::write_frame_header(std::string& out, uint32_t length, uint8_t type,
+                                      uint8_t flags, uint32_t stream_id) {
+    out += static_cast<char>(length >> 16);
+    out += static_cast<char>(length >> 8);
+    out += static_cast<char>(length);
+    out += static_cast<char>(type);
+    out += static_cast<char>(flags);
+    append_u32(out, stream_id & 0x7fffffff);
+}
+
+void Http2Session::write_window_update(std::string& out, uint32_t stream_id, uint32_t increment) {
+    write_frame_header(out, 4, WINDOW_UPDATE, 0, stream_id);
+    append_u32(out, increment & 0x7fffffff);
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Hpack.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+/**
+ * Session HTTP/2 en clair (h2c, RFC 7540) sur une connexion
+ * Découpage des trames, HPACK, contrôle de flux par flux et par connexion.
+ * Les flux multiplexés sont transmis aux handlers HTTP existants dès que
+ * leur requête est complète; les réponses sont écrites dans un buffer de
+ * sortie que l'appelant envoie sur le socket. Les corps produits par
+ * morceaux ne sont générés qu'à mesure que la fenêtre du pair s'ouvre, et
+ * la sortie d'un passage est bornée à MAX_OUTPUT.
+ */
+class Http2Session {
+public:
+    // Handler de route: retourne le code de statut, remplit le corps et d'éventuels
+    // en-têtes supplémentaires (noms en minuscules; content-type/content-length remplacent les défauts).
+    // Un producteur renseigné remplace le corps: il est appelé quand la fenêtre d'envoi le permet
+    using Handler = std::function<HttpResponse::StatusCode(const HttpRequest&, std::string& body,
+                                                           HpackHeaderList& headers,
+                                                           StreamedResponse::Producer& produce)>;
+
+    // Au-delà, les flux attendent que l'appelant ait envoyé la sortie puis appelé resume()
+    static constexpr size_t MAX_OUTPUT = 1024 * 1024;
+
+    static constexpr const char* PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+    static constexpr size_t PREFACE_LEN = 24;
+
+    explicit Http2Session(Handler handler);
+
+    // Le buffer commence-t-il par (un préfixe de) la préface client ?
+    static bool matches_preface(const char* data, size_t len);
+
+    // Connexion "prior knowledge": envoyer les SETTINGS du serveur
+    void start(std::string& out);
+
+    // Connexion "Upgrade: h2c": appliquer HTTP2-Settings et répondre à la
+    // requête d'origine sur le flux 1 (après la réponse 101 de l'appelant)
+    bool start_upgraded(const HttpRequest& request, const std::string& http2_settings, std::string& out);
+
+    // Consommer des octets reçus; false = erreur de connexion (GOAWAY écrit dans out)
+    bool on_data(const char* data, size_t len, std::string& out);
+
+    // Des réponses se sont arrêtées sur MAX_OUTPUT alors que leur fenêtre était ouverte
+    bool output_limited() const { return output_limited_ && !goaway_sent_; }
+
+    // Sortie précédente envoyée: reprendre les réponses arrêtées sur MAX_OUTPUT
+    void resume(std::string& out);
+
+    // GOAWAY reçu et plus aucune réponse en attente, ou GOAWAY envoyé (erreur de connexion)
+    bool finished() const;
+
+private:
+    enum FrameType : uint8_t {
+        DATA = 0x0,
+        HEADERS = 0x1,
+        PRIORITY = 0x2,
+        RST_STREAM = 0x3,
+        SETTINGS = 0x4,
+        PUSH_PROMISE = 0x5,
+        PING = 0x6,
+        GOAWAY = 0x7,
+        WINDOW_UPDATE = 0x8,
+        CONTINUATION = 0x9
+    };
+
+    enum ErrorCode : uint32_t {
+        NO_ERROR = 0x0,
+        PROTOCOL_ERROR = 0x1,
+        INTERNAL_ERROR = 0x2,
+        FLOW_CONTROL_ERROR = 0x3,
+        STREAM_CLOSED = 0x5,
+        FRAME_SIZE_ERROR = 0x6,
+        REFUSED_STREAM = 0x7,
+        CANCEL = 0x8,
+        COMPRESSION_ERROR = 0x9
+    };
+
+    struct FrameHeader {
+        uint32_t length;
+        uint8_t type;
+        uint8_t flags;
+        uint32_t stream_id;
+    };
+
+    struct Stream {
+        HttpRequest request;
+        bool remote_closed = false;      // END_STREAM reçu
+        bool responded = false;
+        int64_t send_window = 0;
+        int64_t recv_window = 0;         // Crédit restant au pair sur ce flux
+        uint32_t recv_unacked = 0;       // Octets reçus non encore rendus par WINDOW_UPDATE
+        std::string pending;             // Corps de réponse pas encore envoyé
+        size_t pending_offset = 0;
+        StreamedResponse::Producer produce;  // Suite du corps, tant que producing
+        bool producing = false;
+    };
+
+    Handler handler_;
+    HpackDecoder decoder_;
+    HpackEncoder encoder_;
+
+    std::string input_;
+    bool preface_received_ = false;
+    bool goaway_received_ = false;
+    bool goaway_sent_ = false;
+    bool output_limited_ = false;
+
+    std::map<uint32_t, Stream> streams_;
+    uint32_t last_stream_id_ = 0;
+
+    // Bloc d'en-têtes en cours (HEADERS + CONTINUATION)
+    uint32_t continuation_stream_ = 0;
+    bool continuation_end_stream_ = false;
+    std::string header_block_;
+
+    // Contrôle de flux
+    int64_t conn_send_window_ = 65535;
+    int64_t conn_recv_window_ = 65535;   // Crédit restant au pair sur la connexion
+    uint32_t conn_recv_unacked_ = 0;
+    uint32_t peer_initial_window_ = 65535;
+    uint32_t peer_max_frame_size_ = 16384;
+
+    bool process_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_data_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_headers_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_continuation_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_settings_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_window_update_frame(const FrameHeader& header, const uint8_t* payload, std::string& out);
+    bool on_header_block_complete(uint32_t stream_id, bool end_stream, std::string& out);
+
+    bool apply_settings(const uint8_t* payload, size_t len, ErrorCode& error);
+    bool build_request(const HpackHeaderList& headers, HttpRequest& request) const;
+    void dispatch(uint32_t stream_id, std::string& out);
+    void flush_stream(uint32_t stream_id, std::string& out);
+    void flush_all(std::string& out);
+    void close_stream_if_done(uint32_t stream_id);
+
+    bool connection_error(ErrorCode code, std::string& out);
+    void reset_stream(uint32_t stream_id, ErrorCode code, std::string& out);
+
+    static void write_frame_header(std::string& out, uint32_t length, uint8_t type,
+                                   uint8_t flags, uint32_t stream_id);
+    static void write_window_update(std::string& out, uint32_t stream_id, uint32_t increment);
+};
@@ -0,0 +1,267 @@
+#include "HttpConditional.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace {
+
+std::string trim(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(begin, end - begin + 1);
+}
+
+// Entier décimal sans signe sur toute la chaîne
+bool parse_size(const std::string& value, size_t& out) {
+    if (value.empty() || value.size() > 19) {
+        return false;
+    }
+    out = 0;
+    for (char c : value) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        out = out * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+std::string content_range(size_t first, size_t last, size_t size) {
+    return "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(size);
+}
+
+void add_validators(const CachedFile& file, HttpResponse::HeaderList& headers) {
+    headers.emplace_back("ETag", file.etag);
+    headers.emplace_back("Last-Modified", file.last_modified);
+}
+
+// Tranche du contenu en cache, sinon plage du fichier lue à l'envoi
+ResponseSegment body_segment(const CachedFile& file, const std::shared_ptr<const FileDescriptor>& disk,
+                             size_t first, size_t length) {
+    if (file.content) {
+        return {file.content, first, length, nullptr};
+    }
+    return {nullptr, first, length, disk};
+}
+
+} // namespace
+
+bool HttpConditional::etag_list_matches(const std::string& header, const std::string& etag, bool strong) {
+    if (trim(header) == "*") {
+        return true;
+    }
+
+    // Comparaison faible: le préfixe W/ est ignoré des deux côtés; forte: il n'est jamais égal
+    bool etag_weak = etag.compare(0, 2, "W/") == 0;
+    std::string opaque = etag_weak ? etag.substr(2) : etag;
+    if (strong && etag_weak) {
+        return false;
+    }
+
+    size_t pos = 0;
+    while (pos < header.size()) {
+        size_t comma = header.find(',', pos);
+        std::string candidate = trim(header.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos));
+        bool candidate_weak = candidate.compare(0, 2, "W/") == 0;
+        if (candidate_weak) {
+            candidate = candidate.substr(2);
+        }
+        if (candidate == opaque && (!strong || !candidate_weak)) {
+            return true;
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return false;
+}
+
+bool HttpConditional::is_not_modified(const HttpRequest& request, const CachedFile& file) {
+    // If-None-Match a priorité: If-Modified-Since n'est alors pas évalué
+    auto inm = request.headers.find("if-none-match");
+    if (inm != request.headers.end()) {
+        return etag_list_matches(inm->second, file.etag, false);
+    }
+
+    time_t since;
+    auto ims = request.headers.find("if-modified-since");
+    return ims != request.headers.end() && FileCache::parse_http_date(ims->second, since) &&
+           file.mtime <= since;
+}
+
+HttpConditional::RangeResult HttpConditional::parse_range(const HttpRequest& request, const CachedFile& file,
+                                                          std::vector<ByteRange>& ranges) {
+    ranges.clear();
+    auto range_header = request.headers.find("range");
+    if (request.method != "GET" || range_header == request.headers.end()) {
+        return RANGE_IGNORED;
+    }
+
+    // If-Range: la plage n'est valable que si la représentation n'a pas changé
+    auto if_range = request.headers.find("if-range");
+    if (if_range != request.headers.end()) {
+        std::string validator = trim(if_range->second);
+        if (validator.empty() || validator[0] == '"' || validator.compare(0, 2, "W/") == 0) {
+            if (!etag_list_matches(validator, file.etag, true)) {
+                return RANGE_IGNORED;
+            }
+        } else {
+            time_t date;
+            if (!FileCache::parse_http_date(validator, date) || date != file.mtime) {
+                return RANGE_IGNORED;
+            }
+        }
+    }
+
+    const std::string& value = range_header->second;
+    if (value.compare(0, 6, "bytes=") != 0) {
+        return RANGE_IGNORED;
+    }
+
+    const size_t size = file.size;
+    size_t pos = 6;
+    size_t specs = 0;
+    while (pos <= value.size()) {
+        size_t comma = value.find(',', pos);
+        std::string spec = trim(value.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos));
+        pos = comma == std::string::npos ? value.size() + 1 : comma + 1;
+        if (spec.empty()) {
+            continue;
+        }
+        if (++specs > MAX_RANGES) {
+            ranges.clear();
+            return RANGE_IGNORED;
+        }
+
+        size_t dash = spec.find('-');
+        if (dash == std::string::npos) {
+            return RANGE_IGNORED;
+        }
+
+        size_t first, last;
+        if (dash == 0) {
+            // Suffixe: les N derniers octets
+            size_t suffix;
+            if (!parse_size(spec.substr(1), suffix)) {
+                return RANGE_IGNORED;
+            }
+            if (suffix == 0 || size == 0) {
+                continue;
+            }
+            first = suffix >= size ? 0 : size - suffix;
+            last = size - 1;
+        } else {
+            if (!parse_size(spec.substr(0, dash), first)) {
+                return RANGE_IGNORED;
+            }
+            std::string end = spec.substr(dash + 1);
+            if (end.empty()) {
+                last = size == 0 ? 0 : size - 1;
+            } else if (!parse_size(end, last) || last < first) {
+                return RANGE_IGNORED;
+            }
+            if (first >= size) {
+                continue; // Plage hors du fichier
+            }
+            last = std::min(last, size - 1);
+        }
+        ranges.push_back({first, last});
+    }
+
+    if (specs == 0) {
+        return RANGE_IGNORED;
+    }
+    if (ranges.empty()) {
+        return RANGE_NOT_SATISFIABLE;
+    }
+
+    // Fusionner les plages qui se chevauchent ou se touchent
+    std::sort(ranges.begin(), ranges.end(),
+              [](const ByteRange& a, const ByteRange& b) { return a.first < b.first; });
+    size_t merged = 0;
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        if (ranges[i].first <= ranges[merged].last + 1) {
+            ranges[merged].last = std::max(ranges[merged].last, ranges[i].last);
+        } else {
+            ranges[++merged] = ranges[i];
+        }
+    }
+    ranges.resize(merged + 1);
+    return RANGE_SATISFIABLE;
+}
+
+void HttpConditional::build_response(const HttpRequest& request, const std::shared_ptr<const CachedFile>& file,
+                                     const std::shared_ptr<const FileDescriptor>& disk, SegmentedResponse& response) {
+    const size_t size = file->size;
+    const bool head = request.method == "HEAD";
+    response.headers.clear();
+    response.body.clear();
+
+    if (is_not_modified(request, *file)) {
+        response.status = HttpResponse::NOT_MODIFIED;
+        add_validators(*file, response.headers);
+        return;
+    }
+
+    std::vector<ByteRange> ranges;
+    RangeResult range = parse_range(request, *file, ranges);
+
+    if (range == RANGE_NOT_SATISFIABLE) {
+        response.status = HttpResponse::RANGE_NOT_SATISFIABLE;
+        response.headers.emplace_back("Content-Range", "bytes */" + std::to_string(size));
+        response.headers.emplace_back("Content-Length", "0");
+        return;
+    }
+
+    if (range == RANGE_IGNORED) {
+        response.status = HttpResponse::OK;
+        response.headers.emplace_back("Content-Type", file->content_type);
+        response.headers.emplace_back("Content-Length", std::to_string(size));
+        response.headers.emplace_back("Accept-Ranges", "bytes");
+        add_validators(*file, response.headers);
+        if (!head && size > 0) {
+            response.body.push_back(body_segment(*file, disk, 0, size));
+        }
+        return;
+    }
+
+    response.status = HttpResponse::PARTIAL_CONTENT;
+
+    if (ranges.size() == 1) {
+        const ByteRange& r = ranges[0];
+        response.headers.emplace_back("Content-Type", file->content_type);
+        response.headers.emplace_back("Content-Length", std::to_string(r.last - r.first + 1));
+        response.headers.emplace_back("Content-Range", content_range(r.first, r.last, size));
+        add_validators(*file, response.headers);
+        response.body.push_back(body_segment(*file, disk, r.first, r.last - r.first + 1));
+        return;
+    }
+
+    // multipart/byteranges: tous les délimiteurs dans un seul buffer, les parties
+    // référencent le contenu en cache (ou le fichier)
+    const std::string boundary = "hps_" + file->etag.substr(file->etag.find('-') + 1, 16);
+    auto delimiters = std::make_shared<std::string>();
+    std::vector<std::pair<size_t, size_t>> delimiter_spans;
+    for (const ByteRange& r : ranges) {
+        size_t start = delimiters->size();
+        *delimiters += "\r\n--" + boundary + "\r\nContent-Type: " + file->content_type +
+                       "\r\nContent-Range: " + content_range(r.first, r.last, size) + "\r\n\r\n";
+        delimiter_spans.emplace_back(start, delimiters->size() - start);
+    }
+    size_t closing = delimiters->size();
+    *delimiters += "\r\n--" + boundary + "--\r\n";
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        response.body.push_back({delimiters, delimiter_spans[i].first, delimiter_spans[i].second, nullptr});
+        response.body.push_back(body_segment(*file, disk, ranges[i].first, ranges[i].last - ranges[i].first + 1));
+    }
+    response.body.push_back({delimiters, closing, delimiters->size() - closing, nullptr});
+
+    response.headers.emplace_back("Content-Type", "multipart/byteranges; boundary=" + boundary);
+    response.headers.emplace_back("Content-Length", std::to_string(response.body_size()));
+    add_validators(*file, response.headers);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "FileCache.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Requêtes conditionnelles et partielles sur un fichier en cache (RFC 9110)
+ * If-None-Match / If-Modified-Since donnent des 304 sans corps, Range des
+ * 206 (une plage ou multipart/byteranges) dont le corps référence le contenu
+ * en cache au lieu de le copier, ou les seules plages demandées du fichier
+ * sur disque quand il n'est pas en cache.
+ */
+class HttpConditional {
+public:
+    struct ByteRange {
+        size_t first;
+        size_t last;    // Inclus
+    };
+
+    enum RangeResult {
+        RANGE_IGNORED,          // Absent, invalide ou trop fragmenté: réponse complète
+        RANGE_SATISFIABLE,
+        RANGE_NOT_SATISFIABLE
+    };
+
+    // Au-delà, l'en-tête Range est ignoré (protection contre les requêtes très fragmentées)
+    static constexpr size_t MAX_RANGES = 16;
+
+    // Construire la réponse (200, 206, 304 ou 416) à un GET/HEAD sur le fichier
+    // (disk: fichier ouvert quand le contenu n'est pas en cache)
+    static void build_response(const HttpRequest& request, const std::shared_ptr<const CachedFile>& file,
+                               const std::shared_ptr<const FileDescriptor>& disk, SegmentedResponse& response);
+
+    // If-None-Match puis If-Modified-Since
+    static bool is_not_modified(const HttpRequest& request, const CachedFile& file);
+
+    // Plages demandées, après If-Range; les plages qui se chevauchent sont fusionnées
+    static RangeResult parse_range(const HttpRequest& request, const CachedFile& file,
+                                   std::vector<ByteRange>& ranges);
+
+    // Liste d'ETags d'un en-tête (ou "*"); comparaison faible ou forte
+    static bool etag_list_matches(const std::string& header, const std::string& etag, bool strong);
+};
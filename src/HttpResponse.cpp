@@ -3,9 +3,13 @@
 
 std::string HttpResponse::get_status_message(StatusCode code) {
     switch (code) {
+        case SWITCHING_PROTOCOLS: return "Switching Protocols";
         case OK: return "OK";
+        case PARTIAL_CONTENT: return "Partial Content";
+        case NOT_MODIFIED: return "Not Modified";
         case BAD_REQUEST: return "Bad Request";
         case NOT_FOUND: return "Not Found";
+        case RANGE_NOT_SATISFIABLE: return "Range Not Satisfiable";
         case INTERNAL_ERROR: return "Internal Server Error";
         default: return "Unknown";
     }
@@ -13,7 +17,7 @@ std::string HttpResponse::get_status_message(StatusCode code) {
 
 std::unordered_map<std::string, std::string> HttpResponse::get_default_headers(bool keep_alive) {
     std::unordered_map<std::string, std::string> headers;
-    headers["Server"] = "High-Performance-HTTP-Server/1.0";
+    headers["Server"] = SERVER_NAME;
     headers["Connection"] = keep_alive ? "keep-alive" : "close";
     if (keep_alive) {
         headers["Keep-Alive"] = "timeout=5, max=1000";
@@ -30,7 +34,7 @@ std::string HttpResponse::build_response(StatusCode code, const std::string& bod
     // Headers
     auto headers = get_default_headers(keep_alive);
     headers["Content-Length"] = std::to_string(body.size());
-    headers["Content-Type"] = "text/html; charset=utf-8";
+    headers["Content-Type"] = DEFAULT_CONTENT_TYPE;
     
     for (const auto& header : headers) {
         oss << header.first << ": " << header.second << "\r\n";
@@ -41,3 +45,43 @@ std::string HttpResponse::build_response(StatusCode code, const std::string& bod
     
     return oss.str();
 }
+
+std::string HttpResponse::build_switching_protocols(const std::string& protocol,
+                                                   const std::unordered_map<std::string, std::string>& extra_headers) {
+    std::ostringstream oss;
+
+    oss << "HTTP/1.1 " << SWITCHING_PROTOCOLS << " " << get_status_message(SWITCHING_PROTOCOLS) << "\r\n";
+    oss << "Connection: Upgrade\r\n";
+    oss << "Upgrade: " << protocol << "\r\n";
+
+    for (const auto& header : extra_headers) {
+        oss << header.first << ": " << header.second << "\r\n";
+    }
+
+    oss << "\r\n";
+    return oss.str();
+}
+
+std::string HttpResponse::build_head(StatusCode code, const HeaderList& headers, bool keep_alive) {
+    std::ostringstream oss;
+
+    oss << "HTTP/1.1 " << code << " " << get_status_message(code) << "\r\n";
+
+    for (const auto& header : get_default_headers(keep_alive)) {
+        oss << header.first << ": " << header.second << "\r\n";
+    }
+    for (const auto& header : headers) {
+        oss << header.first << ": " << header.second << "\r\n";
+    }
+
+    oss << "\r\n";
+    return oss.str();
+}
+
+size_t SegmentedResponse::body_size() const {
+    size_t size = 0;
+    for (const auto& segment : body) {
+        size += segment.length;
+    }
+    return size;
+}
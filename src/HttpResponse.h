@@ -1,7 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+class FileDescriptor;
 
 /**
  * Gestionnaire de réponses HTTP
@@ -9,15 +16,73 @@
 class HttpResponse {
 public:
     enum StatusCode {
+        SWITCHING_PROTOCOLS = 101,
         OK = 200,
+        PARTIAL_CONTENT = 206,
+        NOT_MODIFIED = 304,
         BAD_REQUEST = 400,
         NOT_FOUND = 404,
+        RANGE_NOT_SATISFIABLE = 416,
         INTERNAL_ERROR = 500
     };
 
+    // En-têtes ordonnés (noms en casse HTTP/1.1)
+    using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr const char* SERVER_NAME = "High-Performance-HTTP-Server/1.0";
+    static constexpr const char* DEFAULT_CONTENT_TYPE = "text/html; charset=utf-8";
+
     static std::string build_response(StatusCode code, const std::string& body = "", bool keep_alive = true);
+
+    // Réponse 101 pour un changement de protocole (h2c, websocket)
+    static std::string build_switching_protocols(const std::string& protocol,
+                                                 const std::unordered_map<std::string, std::string>& extra_headers = {});
     static std::string get_status_message(StatusCode code);
 
+    // Ligne de statut et en-têtes seuls (le corps est envoyé à part);
+    // Content-Length et Content-Type sont fournis par l'appelant
+    static std::string build_head(StatusCode code, const HeaderList& headers, bool keep_alive);
+
 private:
     static std::unordered_map<std::string, std::string> get_default_headers(bool keep_alive);
 };
+
+/**
+ * Tranche d'un buffer partagé, envoyée sans copie, ou plage d'un fichier
+ * ouvert (data nul, offset dans le fichier) lue au moment de l'envoi
+ */
+struct ResponseSegment {
+    std::shared_ptr<const std::string> data;
+    size_t offset;
+    size_t length;
+    std::shared_ptr<const FileDescriptor> file;
+};
+
+/**
+ * Réponse dont le corps référence des buffers partagés (cache de fichiers,
+ * délimiteurs multipart) ou des plages de fichier: HTTP/1.1 l'envoie par
+ * writev, HTTP/2 la copie dans ses trames DATA
+ */
+struct SegmentedResponse {
+    HttpResponse::StatusCode status = HttpResponse::OK;
+    HttpResponse::HeaderList headers;
+    std::vector<ResponseSegment> body;
+
+    size_t body_size() const;
+};
+
+/**
+ * Réponse dont le corps est produit à la demande (routes de flux)
+ * Le producteur n'est appelé que lorsque le destinataire peut recevoir la
+ * suite: socket inscriptible en HTTP/1.x, fenêtre de flux ouverte en HTTP/2.
+ */
+struct StreamedResponse {
+    // Ajouter la suite du corps à chunk (quelques Ko); false une fois le corps terminé
+    using Producer = std::function<bool(std::string& chunk)>;
+
+    HttpResponse::StatusCode status = HttpResponse::OK;
+    HttpResponse::HeaderList headers;
+    bool has_length = false;
+    size_t content_length = 0;
+    Producer produce;
+};
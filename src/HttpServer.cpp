@@ -1,6 +1,14 @@
 #include "HttpServer.h"
+#include "CpuAffinity.h"
+#include "HttpConditional.h"
+#include "RecordFormat.h"
+#include "ResponseWriter.h"
+#ifdef HTTP_SERVER_TLS
+#include "TlsContext.h"
+#endif
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <cstring>
 #include <iostream>
 #include <sstream>
@@ -10,11 +18,62 @@
 #include <mutex>
 #include <stdexcept>
 #include <exception>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+// Délai maximal de conservation d'un socket fermé dont des envois MSG_ZEROCOPY
+// ne sont pas encore confirmés
+constexpr int64_t ZEROCOPY_ORPHAN_TIMEOUT_MS = 30000;
+
+// Octets envoyés par passage avant de rendre le worker aux autres connexions
+constexpr size_t RESPONSE_SLICE_BYTES = 4 * 1024 * 1024;
+
+// Corps statique copié par appel du producteur HTTP/2
+constexpr size_t H2_CHUNK_BYTES = 64 * 1024;
+
+ServerConfig make_config(int port, size_t thread_pool_size, size_t max_connections) {
+    ServerConfig config;
+    config.port = port;
+    config.thread_pool_size = thread_pool_size;
+    config.max_connections = max_connections;
+    return config;
+}
+
+// CPUs des workers: liste explicite, sinon ceux du nœud NUMA, sinon aucun épinglage
+std::vector<int> worker_cpus_for(const ServerConfig& config) {
+    if (!config.worker_cpus.empty()) {
+        return config.worker_cpus;
+    }
+    if (config.numa_node >= 0) {
+        return CpuAffinity::cpus_of_numa_node(config.numa_node);
+    }
+    return {};
+}
+
+} // namespace
 
 HttpServer::HttpServer(int port, size_t thread_pool_size, size_t max_connections)
-    : port_(port), server_fd_(-1), epoll_fd_(-1), running_(false),
-      thread_pool_(std::make_unique<ThreadPool>(thread_pool_size)),
-      max_connections_(max_connections) {
+    : HttpServer(make_config(port, thread_pool_size, max_connections)) {
+}
+
+HttpServer::HttpServer(const ServerConfig& config)
+    : config_(config), port_(config.port), server_fd_(-1), tls_server_fd_(-1), epoll_fd_(-1), running_(false),
+      thread_pool_(std::make_unique<ThreadPool>(config.thread_pool_size, worker_cpus_for(config))),
+      ws_hub_(std::chrono::seconds(config.ws_ping_interval), std::chrono::seconds(config.ws_pong_timeout)),
+      max_connections_(config.max_connections) {
+    if (!config.access_log_path.empty()) {
+        access_log_ = std::make_unique<AccessLog>(
+            config.access_log_path, config.access_log_format, config.thread_pool_size,
+            config.access_log_max_bytes, config.access_log_files);
+    }
+    if (!config.static_root.empty()) {
+        file_cache_ = std::make_unique<FileCache>(config.static_root, config.file_cache_bytes);
+    }
+    if (config.trace_sample_rate > 0.0) {
+        tracer_ = std::make_unique<RequestTracer>(config.trace_sample_rate, config.thread_pool_size);
+    }
 }
 
 HttpServer::~HttpServer() {
@@ -22,41 +81,93 @@ HttpServer::~HttpServer() {
 }
 
 bool HttpServer::setup_server_socket() {
-    // Créer le socket
-    server_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    server_fd_ = open_listener(port_);
     if (server_fd_ < 0) {
-        std::cerr << "Erreur: impossible de créer le socket" << std::endl;
         return false;
     }
+    std::cout << "Serveur HTTP démarré sur le port " << port_ << std::endl;
 
-    // Options du socket pour réutiliser l'adresse
-    int opt = 1;
-    if (setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
-        std::cerr << "Erreur: setsockopt échoué" << std::endl;
+    if (config_.tls_port <= 0) {
+        return true;
+    }
+
+#ifdef HTTP_SERVER_TLS
+    tls_context_ = std::make_unique<TlsContext>();
+    if (!tls_context_->init(config_.tls_cert, config_.tls_key, config_.ktls)) {
+        return false;
+    }
+
+    tls_server_fd_ = open_listener(config_.tls_port);
+    if (tls_server_fd_ < 0) {
         return false;
     }
+    std::cout << "Serveur HTTPS démarré sur le port " << config_.tls_port
+              << (config_.ktls ? " (kTLS si disponible)" : "") << std::endl;
+    return true;
+#else
+    std::cerr << "Erreur: serveur compilé sans support TLS (ENABLE_TLS=OFF)" << std::endl;
+    return false;
+#endif
+}
+
+int HttpServer::open_listener(int port) {
+    // Créer le socket
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        std::cerr << "Erreur: impossible de créer le socket" << std::endl;
+        return -1;
+    }
+
+    // Options du socket (réutilisation de l'adresse + profil de réglage)
+    if (!SocketTuning::apply_listener(fd, config_.socket_options)) {
+        std::cerr << "Erreur: setsockopt échoué" << std::endl;
+        ::close(fd);
+        return -1;
+    }
+
+    // Steering: garder les connexions sur le cœur qui traite leur file RX
+    if (config_.incoming_cpu && config_.reactor_cpu >= 0) {
+        SocketTuning::set_incoming_cpu(fd, config_.reactor_cpu);
+    }
 
     // Configurer l'adresse
     struct sockaddr_in address;
     std::memset(&address, 0, sizeof(address));
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port_);
+    address.sin_port = htons(port);
 
     // Bind
-    if (bind(server_fd_, (struct sockaddr*)&address, sizeof(address)) < 0) {
-        std::cerr << "Erreur: bind échoué sur le port " << port_ << std::endl;
-        return false;
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        std::cerr << "Erreur: bind échoué sur le port " << port << std::endl;
+        ::close(fd);
+        return -1;
     }
 
     // Listen avec une grande backlog pour supporter C10k
-    if (listen(server_fd_, 4096) < 0) {
+    if (listen(fd, 4096) < 0) {
         std::cerr << "Erreur: listen échoué" << std::endl;
-        return false;
+        ::close(fd);
+        return -1;
     }
 
-    std::cout << "Serveur HTTP démarré sur le port " << port_ << std::endl;
-    return true;
+    // Le programme s'applique à tout le groupe SO_REUSEPORT: un seul membre suffit
+    if (config_.reuseport_cbpf_group > 0) {
+        SocketTuning::attach_reuseport_cbpf(fd, config_.reuseport_cbpf_group);
+    }
+
+    return fd;
+}
+
+void HttpServer::pin_reactor_thread() {
+    if (config_.reactor_cpu >= 0) {
+        if (!CpuAffinity::pin_current_thread(config_.reactor_cpu)) {
+            std::cerr << "Avertissement: impossible d'épingler le reactor sur le CPU "
+                      << config_.reactor_cpu << std::endl;
+        }
+    } else if (config_.numa_node >= 0) {
+        CpuAffinity::pin_current_thread(CpuAffinity::cpus_of_numa_node(config_.numa_node));
+    }
 }
 
 bool HttpServer::setup_epoll() {
@@ -76,16 +187,24 @@ bool HttpServer::setup_epoll() {
         return false;
     }
 
+    if (tls_server_fd_ >= 0) {
+        ev.data.fd = tls_server_fd_;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, tls_server_fd_, &ev) < 0) {
+            std::cerr << "Erreur: epoll_ctl échoué" << std::endl;
+            return false;
+        }
+    }
+
     return true;
 }
 
-void HttpServer::accept_connection() {
+void HttpServer::accept_connection(int listen_fd) {
     struct sockaddr_in client_addr;
     socklen_t client_addr_len = sizeof(client_addr);
     
     // Accepter toutes les connexions en attente (edge-triggered)
     while (true) {
-        int client_fd = accept4(server_fd_, (struct sockaddr*)&client_addr, 
+        int client_fd = accept4(listen_fd, (struct sockaddr*)&client_addr, 
                                &client_addr_len, SOCK_NONBLOCK);
         
         if (client_fd < 0) {
@@ -97,16 +216,38 @@ void HttpServer::accept_connection() {
             break;
         }
 
+        SocketTuning::apply_client(client_fd, config_.socket_options);
+
+        // Connexion HTTPS: la poignée de main avance au fil des événements epoll
+        SSL* ssl = nullptr;
+#ifdef HTTP_SERVER_TLS
+        if (listen_fd == tls_server_fd_) {
+            ssl = tls_context_->create_ssl(client_fd);
+            if (!ssl) {
+                TlsContext::log_errors("SSL_new");
+                ::close(client_fd);
+                continue;
+            }
+        }
+#endif
+
         // Vérifier la limite de connexions
         {
             std::lock_guard<std::mutex> lock(connections_mutex_);
             if (connections_.size() >= max_connections_) {
-                ::close(client_fd);
+                Connection rejected(client_fd, client_addr, ssl);
                 continue;
             }
 
             // Créer la connexion
-            auto conn = std::make_unique<Connection>(client_fd, client_addr);
+            auto conn = std::make_unique<Connection>(client_fd, client_addr, ssl);
+            if (tracer_) {
+                conn->accepted_ns = RequestTracer::now_ns();
+            }
+            // MSG_ZEROCOPY en clair seulement: TLS en espace utilisateur chiffre dans ses propres buffers
+            if (config_.zerocopy_threshold > 0 && !ssl && ZeroCopySender::enable(client_fd)) {
+                conn->zerocopy = std::make_unique<ZeroCopySender>();
+            }
             connections_[client_fd] = std::move(conn);
         }
 
@@ -125,6 +266,7 @@ void HttpServer::accept_connection() {
 void HttpServer::handle_epoll_events() {
     const int MAX_EVENTS = 256;
     struct epoll_event events[MAX_EVENTS];
+    int64_t last_keepalive_check = WebSocketHub::now_ms();
     
     while (running_) {
         int num_events = epoll_wait(epoll_fd_, events, MAX_EVENTS, 100);
@@ -138,22 +280,51 @@ void HttpServer::handle_epoll_events() {
         }
 
         for (int i = 0; i < num_events; ++i) {
-            if (events[i].data.fd == server_fd_) {
+            int fd = events[i].data.fd;
+            if (fd == server_fd_ || fd == tls_server_fd_) {
                 // Nouvelle connexion
-                accept_connection();
+                accept_connection(fd);
             } else {
                 // Données à lire
                 if (events[i].events & EPOLLIN) {
-                    handle_read(events[i].data.fd);
+                    handle_read(fd);
+                }
+                // Connexions WebSocket et poignées de main TLS en attente d'écriture
+                if (events[i].events & EPOLLOUT) {
+                    handle_write(fd);
+                }
+                // File d'erreurs seule: notifications MSG_ZEROCOPY ou erreur du socket
+                if (!(events[i].events & (EPOLLIN | EPOLLOUT)) && (events[i].events & (EPOLLERR | EPOLLHUP))) {
+                    handle_error(fd, events[i].events);
                 }
             }
         }
+
+        // Keepalive WebSocket et sockets zero-copy fermés, une fois par seconde
+        int64_t now = WebSocketHub::now_ms();
+        if (now - last_keepalive_check >= 1000) {
+            ws_hub_.check_keepalive();
+            reap_zerocopy_orphans(false);
+            // Sur un worker: l'access log n'a de ring que pour les threads du pool
+            thread_pool_->enqueue([this]() { expire_parked_responses(); });
+            last_keepalive_check = now;
+        }
+
+        // Export demandé par SIGUSR1: écriture du fichier hors du reactor
+        if (trace_export_requested_.exchange(false, std::memory_order_relaxed) && tracer_) {
+            thread_pool_->enqueue([this]() { export_traces(); });
+        }
     }
 }
 
 void HttpServer::handle_read(int client_fd) {
+    // Échantillonnage décidé ici pour horodater la mise en file
+    const int64_t enqueue_ns = tracer_ && tracer_->should_sample() ? RequestTracer::now_ns() : 0;
+
     // Déléguer la lecture au thread pool
-    thread_pool_->enqueue([this, client_fd]() {
+    thread_pool_->enqueue([this, client_fd, enqueue_ns]() {
+        const int64_t dequeue_ns = enqueue_ns ? RequestTracer::now_ns() : 0;
+
         std::unique_lock<std::mutex> lock(connections_mutex_);
         auto it = connections_.find(client_fd);
         if (it == connections_.end()) {
@@ -161,19 +332,34 @@ void HttpServer::handle_read(int client_fd) {
         }
         
         Connection* conn = it->second.get();
+        std::shared_ptr<WebSocketSession> ws = conn->ws;
         lock.unlock();
 
-        // Lire les données
-        ssize_t n = recv(client_fd, conn->buffer.data() + conn->bytes_read,
-                        conn->buffer.size() - conn->bytes_read - 1, 0);
+        // WebSocket: epoll sans EPOLLONESHOT, plusieurs tâches peuvent arriver ici
+        if (ws) {
+            handle_ws_read(ws);
+            return;
+        }
+
+        // Libérer les buffers dont le noyau a terminé l'envoi
+        if (conn->zerocopy && !conn->zerocopy->idle()) {
+            conn->zerocopy->drain(client_fd);
+        }
+
+        // TLS: terminer la poignée de main avant toute donnée applicative
+        if (conn->ssl && !conn->tls_established && !advance_tls_handshake(conn)) {
+            return;
+        }
+
+        // Lire les données (en HTTP/2 la session conserve elle-même les trames incomplètes)
+        size_t offset = conn->h2 ? 0 : conn->bytes_read;
+        ssize_t n = conn->read(conn->buffer.data() + offset,
+                               conn->buffer.size() - offset - 1);
 
         if (n < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
                 // Réactiver epoll pour cette socket
-                struct epoll_event ev;
-                ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
-                ev.data.fd = client_fd;
-                epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
+                rearm_connection(client_fd);
                 return;
             }
             close_connection(client_fd);
@@ -186,9 +372,32 @@ void HttpServer::handle_read(int client_fd) {
             return;
         }
 
+        if (conn->bytes_read == 0) {
+            conn->request_start = std::chrono::steady_clock::now();
+        }
+
+        if (conn->h2) {
+            process_h2_data(conn, conn->buffer.data(), n);
+            return;
+        }
+
         conn->bytes_read += n;
         conn->buffer[conn->bytes_read] = '\0';
 
+        // Préface HTTP/2 "prior knowledge" (contient elle-même un double CRLF)
+        if (Http2Session::matches_preface(conn->buffer.data(), conn->bytes_read)) {
+            if (conn->bytes_read < Http2Session::PREFACE_LEN) {
+                resume_connection(conn);
+                return;
+            }
+            conn->h2 = std::make_unique<Http2Session>(make_h2_handler(conn));
+            conn->h2->start(conn->h2_output);
+            size_t len = conn->bytes_read;
+            conn->bytes_read = 0;
+            process_h2_data(conn, conn->buffer.data(), len);
+            return;
+        }
+
         // Chercher la fin de la requête HTTP (double CRLF)
         std::string request_data(conn->buffer.data(), conn->bytes_read);
         size_t header_end = request_data.find("\r\n\r\n");
@@ -196,134 +405,841 @@ void HttpServer::handle_read(int client_fd) {
         if (header_end != std::string::npos) {
             // Requête complète reçue
             request_data = request_data.substr(0, header_end + 4);
-            process_request(client_fd, request_data);
+            if (enqueue_ns) {
+                RequestTrace trace;
+                trace.accept_ns = conn->request_count == 0 ? conn->accepted_ns : 0;
+                trace.enqueue_ns = enqueue_ns;
+                trace.dequeue_ns = dequeue_ns;
+                trace.recv_ns = RequestTracer::now_ns();
+                trace.thread = tracer_->thread_index();
+                process_request(conn, request_data, &trace);
+            } else {
+                process_request(conn, request_data);
+            }
         } else if (conn->bytes_read >= static_cast<ssize_t>(conn->buffer.size() - 1)) {
             // Buffer plein sans fin de requête
             close_connection(client_fd);
             return;
         } else {
             // Réactiver epoll pour lire plus de données
-            struct epoll_event ev;
-            ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
-            ev.data.fd = client_fd;
-            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
+            resume_connection(conn);
         }
     });
 }
 
-void HttpServer::process_request(int client_fd, const std::string& request_data) {
+void HttpServer::process_request(Connection* conn, const std::string& request_data, RequestTrace* trace) {
+    HttpRequest request;
+    std::unique_ptr<ResponseStream> stream;
+
     try {
-        HttpRequest request;
-        
         if (!HttpRequest::parse(request_data, request)) {
             // Requête invalide
-            std::string response = HttpResponse::build_response(
-                HttpResponse::BAD_REQUEST, 
-                "<html><body><h1>400 Bad Request</h1><p>La requête HTTP est invalide.</p></body></html>",
-                false
-            );
-            send_response(client_fd, response);
-            close_connection(client_fd);
+            send_error(conn, std::move(request), HttpResponse::BAD_REQUEST,
+                       "<html><body><h1>400 Bad Request</h1><p>La requête HTTP est invalide.</p></body></html>");
             return;
         }
 
-        // Générer la réponse
-        std::string response_body;
-        HttpResponse::StatusCode status_code = HttpResponse::OK;
-        
-        try {
-            response_body = generate_response(request);
-            
-            if (response_body.empty() && request.method == "GET") {
-                // Route non trouvée
-                status_code = HttpResponse::NOT_FOUND;
-                response_body = "<html><body><h1>404 Not Found</h1><p>La ressource demandée n'existe pas.</p></body></html>";
-            } else if (response_body.empty()) {
-                // Méthode non supportée (non-GET)
-                status_code = HttpResponse::BAD_REQUEST;
-                response_body = "<html><body><h1>405 Method Not Allowed</h1><p>La méthode HTTP n'est pas supportée.</p></body></html>";
+        if (trace) {
+            trace->parse_ns = RequestTracer::now_ns();
+        }
+
+        // HTTP/2 en clair via Upgrade: h2c
+        if (try_upgrade_h2c(conn, request)) {
+            return;
+        }
+
+        if (try_upgrade_websocket(conn, request)) {
+            return;
+        }
+
+        // Fichier statique (validateurs, 304, plages), route de flux, sinon handlers générés
+        ResponseWriter writer(conn, request, config_.zerocopy_threshold);
+        SegmentedResponse static_response;
+        StreamedResponse streamed;
+        if (serve_static(request, static_response)) {
+            queue_segmented(writer, static_response);
+        } else if (stream_route(request, streamed)) {
+            // Corps produit au fil des envois par continue_response
+            writer.set_status(streamed.status);
+            for (const auto& header : streamed.headers) {
+                writer.set_header(header.first, header.second);
             }
-        } catch (const std::exception& e) {
-            // Erreur interne du serveur
-            status_code = HttpResponse::INTERNAL_ERROR;
-            response_body = "<html><body><h1>500 Internal Server Error</h1><p>Une erreur interne s'est produite.</p></body></html>";
-            std::cerr << "Erreur lors de la génération de la réponse: " << e.what() << std::endl;
+            if (streamed.has_length) {
+                writer.set_content_length(streamed.content_length);
+            }
+        } else {
+            std::string response_body;
+            HttpResponse::StatusCode status_code = route_request(request, response_body);
+            // Corps partagé plutôt que recopié derrière les en-têtes (MSG_ZEROCOPY au-delà du seuil)
+            auto body = std::make_shared<const std::string>(std::move(response_body));
+            writer.set_status(status_code);
+            writer.set_content_length(body->size());
+            writer.write_segment({body, 0, body->size(), nullptr});
+            writer.finish();
+        }
+
+        // Corps en flux: le handler se termine avec le producteur (continue_response)
+        if (trace && !streamed.produce) {
+            trace->handler_ns = RequestTracer::now_ns();
+        }
+
+        stream = std::make_unique<ResponseStream>(conn, std::move(request), std::move(writer));
+        stream->produce = std::move(streamed.produce);
+        if (trace) {
+            stream->trace = *trace;
+            stream->traced = true;
         }
+    } catch (const std::exception& e) {
+        // Erreur critique lors du traitement de la requête
+        std::cerr << "Erreur critique lors du traitement de la requête: " << e.what() << std::endl;
+        send_error(conn, std::move(request), HttpResponse::INTERNAL_ERROR,
+                   "<html><body><h1>500 Internal Server Error</h1><p>Une erreur interne s'est produite.</p></body></html>");
+        return;
+    }
+
+    // Hors du try: la connexion peut être fermée pendant l'envoi
+    continue_response(std::move(stream));
+}
+
+HttpResponse::StatusCode HttpServer::route_request(const HttpRequest& request, std::string& response_body) {
+    HttpResponse::StatusCode status_code = HttpResponse::OK;
+
+    try {
+        response_body = generate_response(request);
         
-        std::string response = HttpResponse::build_response(
-            status_code,
-            response_body,
-            request.keep_alive
-        );
+        if (response_body.empty() && request.method == "GET") {
+            // Route non trouvée
+            status_code = HttpResponse::NOT_FOUND;
+            response_body = "<html><body><h1>404 Not Found</h1><p>La ressource demandée n'existe pas.</p></body></html>";
+        } else if (response_body.empty()) {
+            // Méthode non supportée (non-GET)
+            status_code = HttpResponse::BAD_REQUEST;
+            response_body = "<html><body><h1>405 Method Not Allowed</h1><p>La méthode HTTP n'est pas supportée.</p></body></html>";
+        }
+    } catch (const std::exception& e) {
+        // Erreur interne du serveur
+        status_code = HttpResponse::INTERNAL_ERROR;
+        response_body = "<html><body><h1>500 Internal Server Error</h1><p>Une erreur interne s'est produite.</p></body></html>";
+        std::cerr << "Erreur lors de la génération de la réponse: " << e.what() << std::endl;
+    }
+
+    return status_code;
+}
+
+bool HttpServer::try_upgrade_h2c(Connection* conn, const HttpRequest& request) {
+    // Upgrade: h2c accompagné de HTTP2-Settings, sur une requête sans corps
+    std::string upgrade = request.get_header("upgrade");
+    std::transform(upgrade.begin(), upgrade.end(), upgrade.begin(), ::tolower);
+    // h2c est réservé au clair: en TLS, HTTP/2 se négocie par ALPN
+    if (conn->ssl || upgrade.find("h2c") == std::string::npos || request.version != "HTTP/1.1" ||
+        request.headers.count("http2-settings") == 0 || !request.get_header("content-length").empty()) {
+        return false;
+    }
+
+    auto session = std::make_unique<Http2Session>(make_h2_handler(conn));
+    std::string out = HttpResponse::build_switching_protocols("h2c");
+    if (!session->start_upgraded(request, request.get_header("http2-settings"), out)) {
+        return false; // Paramètres invalides: rester en HTTP/1.1
+    }
+
+    conn->h2 = std::move(session);
+    conn->h2_output = std::move(out);
+    conn->h2_output_sent = 0;
+    conn->reset();
+    send_h2_output(conn);
+    return true;
+}
+
+Http2Session::Handler HttpServer::make_h2_handler(Connection* conn) {
+    return [this, conn](const HttpRequest& request, std::string& body, HpackHeaderList& headers,
+                        StreamedResponse::Producer& produce) {
+        SegmentedResponse static_response;
+        StreamedResponse streamed;
+        HttpResponse::HeaderList extra;
+        HttpResponse::StatusCode status;
+        size_t body_size = 0;
 
-        send_response(client_fd, response);
+        if (serve_static(request, static_response)) {
+            // Segments copiés dans les trames DATA à mesure que la fenêtre s'ouvre
+            status = static_response.status;
+            extra = std::move(static_response.headers);
+            for (const auto& segment : static_response.body) {
+                body_size += segment.length;
+            }
+            if (body_size > 0) {
+                produce = [segments = std::move(static_response.body), index = size_t(0),
+                           offset = size_t(0)](std::string& chunk) mutable {
+                    const ResponseSegment& segment = segments[index];
+                    size_t len = std::min(H2_CHUNK_BYTES, segment.length - offset);
+                    if (segment.file) {
+                        // Plage d'un fichier hors cache: lue au fil de la fenêtre d'envoi
+                        chunk.resize(len);
+                        ssize_t n = ::pread(segment.file->get(), &chunk[0], len,
+                                            static_cast<off_t>(segment.offset + offset));
+                        if (n != static_cast<ssize_t>(len)) {
+                            throw std::runtime_error("fichier tronqué pendant l'envoi");
+                        }
+                    } else {
+                        chunk.assign(segment.data->data() + segment.offset + offset, len);
+                    }
+                    offset += len;
+                    if (offset == segment.length) {
+                        ++index;
+                        offset = 0;
+                    }
+                    return index < segments.size();
+                };
+            }
+        } else if (stream_route(request, streamed)) {
+            status = streamed.status;
+            extra = std::move(streamed.headers);
+            if (streamed.has_length) {
+                body_size = streamed.content_length;
+                extra.emplace_back("content-length", std::to_string(streamed.content_length));
+            }
+            produce = std::move(streamed.produce);
+        } else {
+            status = route_request(request, body);
+            body_size = body.size();
+        }
+
+        for (auto& header : extra) {
+            std::transform(header.first.begin(), header.first.end(), header.first.begin(), ::tolower);
+            headers.emplace_back(std::move(header.first), std::move(header.second));
+        }
+        log_access(conn, request, status, body_size);
+        return status;
+    };
+}
+
+void HttpServer::process_h2_data(Connection* conn, const char* data, size_t len) {
+    // Erreur de connexion: le GOAWAY termine la sortie, la connexion est fermée
+    // une fois celle-ci envoyée (finished())
+    conn->h2->on_data(data, len, conn->h2_output);
+    send_h2_output(conn);
+}
+
+void HttpServer::send_h2_output(Connection* conn) {
+    const int client_fd = conn->fd;
+    std::string& out = conn->h2_output;
+    size_t sent = 0;
 
-        // Gérer keep-alive
+    while (true) {
+        while (conn->h2_output_sent < out.size()) {
+            ssize_t n = conn->write(out.data() + conn->h2_output_sent, out.size() - conn->h2_output_sent);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    // Pas de lecture pendant l'attente: un pair qui ne lit pas n'envoie plus de requêtes
+                    park_response(client_fd, nullptr);
+                    return;
+                }
+                close_connection(client_fd);
+                return;
+            }
+            conn->h2_output_sent += static_cast<size_t>(n);
+            sent += static_cast<size_t>(n);
+        }
+        out.clear();
+        conn->h2_output_sent = 0;
+
+        if (!conn->h2->output_limited()) {
+            break;
+        }
+        if (sent >= RESPONSE_SLICE_BYTES) {
+            park_response(client_fd, nullptr); // Socket inscriptible: reprise immédiate
+            return;
+        }
+        conn->h2->resume(out);
+    }
+
+    if (conn->h2->finished()) {
+        close_connection(client_fd);
+    } else {
+        resume_connection(conn);
+    }
+}
+
+void HttpServer::handle_write(int client_fd) {
+    thread_pool_->enqueue([this, client_fd]() {
+        // Réponse garée: le socket accepte de nouveau des octets
+        std::unique_ptr<ResponseStream> stream;
+        bool parked = claim_parked_response(client_fd, stream);
+        if (stream) {
+            continue_response(std::move(stream));
+            return;
+        }
+
+        Connection* conn = nullptr;
+        std::shared_ptr<WebSocketSession> ws;
         {
             std::lock_guard<std::mutex> lock(connections_mutex_);
             auto it = connections_.find(client_fd);
-            if (it != connections_.end()) {
-                it->second->keep_alive = request.keep_alive;
-                it->second->reset();
-                
-                if (request.keep_alive) {
-                    // Réactiver epoll pour cette connexion
-                    struct epoll_event ev;
-                    ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
-                    ev.data.fd = client_fd;
-                    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
-                } else {
-                    close_connection(client_fd);
-                }
+            if (it == connections_.end()) {
+                return;
             }
+            conn = it->second.get();
+            ws = conn->ws;
         }
-    } catch (const std::exception& e) {
-        // Erreur critique lors du traitement de la requête
-        std::cerr << "Erreur critique lors du traitement de la requête: " << e.what() << std::endl;
-        std::string response = HttpResponse::build_response(
-            HttpResponse::INTERNAL_ERROR,
-            "<html><body><h1>500 Internal Server Error</h1><p>Une erreur interne s'est produite.</p></body></html>",
-            false
-        );
-        send_response(client_fd, response);
+        if (parked) {
+            send_h2_output(conn);
+            return;
+        }
+        if (ws) {
+            ws->flush();
+            return;
+        }
+
+        // Poignée de main TLS bloquée en écriture (EPOLLONESHOT: ce worker en est seul détenteur)
+        if (conn->ssl && !conn->tls_established && advance_tls_handshake(conn)) {
+            handle_read(client_fd);
+        }
+    });
+}
+
+bool HttpServer::advance_tls_handshake(Connection* conn) {
+    struct epoll_event ev;
+    ev.data.fd = conn->fd;
+
+    switch (conn->tls_handshake()) {
+        case Connection::HANDSHAKE_DONE:
+            // ALPN "h2": le client enchaîne directement avec la préface HTTP/2,
+            // détectée comme en clair par handle_read
+            return true;
+        case Connection::HANDSHAKE_WANT_READ:
+            ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn->fd, &ev);
+            return false;
+        case Connection::HANDSHAKE_WANT_WRITE:
+            ev.events = EPOLLOUT | EPOLLET | EPOLLONESHOT;
+            epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn->fd, &ev);
+            return false;
+        default:
+            close_connection(conn->fd);
+            return false;
+    }
+}
+
+bool HttpServer::try_upgrade_websocket(Connection* conn, const HttpRequest& request) {
+    if (request.path != "/ws" || !WebSocket::is_upgrade_request(request)) {
+        return false;
+    }
+
+    const int client_fd = conn->fd;
+    auto response = std::make_shared<const std::string>(HttpResponse::build_switching_protocols(
+        "websocket", {{"Sec-WebSocket-Accept", WebSocket::accept_key(request.get_header("sec-websocket-key"))}}));
+
+    // La 101 passe par la file de la session (reste envoyé sur EPOLLOUT), avant toute diffusion
+    auto session = std::make_shared<WebSocketSession>(conn);
+    if (!session->send(response)) {
         close_connection(client_fd);
+        return true;
+    }
+    log_access(conn, request, HttpResponse::SWITCHING_PROTOCOLS, response->size());
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        conn->ws = session;
+        conn->reset();
     }
+    ws_hub_.subscribe(session);
+
+    // Plus d'EPOLLONESHOT: les diffusions écrivent depuis n'importe quel thread
+    // et doivent être notifiées (EPOLLOUT) quand le socket redevient inscriptible
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLET | EPOLLRDHUP;
+    ev.data.fd = client_fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
+    return true;
 }
 
-void HttpServer::send_response(int client_fd, const std::string& response) {
-    size_t total_sent = 0;
-    size_t len = response.length();
+void HttpServer::handle_ws_read(const std::shared_ptr<WebSocketSession>& session) {
+    if (!session->begin_read()) {
+        return; // Le lecteur actif refera un passage
+    }
 
-    while (total_sent < len) {
-        ssize_t n = send(client_fd, response.data() + total_sent, 
-                        len - total_sent, MSG_NOSIGNAL);
-        
+    int handled = 1;
+    do {
+        if (session->closed()) {
+            return;
+        }
+        if (!drain_websocket(session)) {
+            return; // Session fermée: les lectures suivantes l'ignoreront
+        }
+    } while (!session->end_read(handled));
+}
+
+bool HttpServer::drain_websocket(const std::shared_ptr<WebSocketSession>& session) {
+    char buffer[16384];
+
+    while (true) {
+        ssize_t n = session->read(buffer, sizeof(buffer));
         if (n < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                // Réessayer
+            if (errno == EINTR) {
                 continue;
             }
-            // Erreur d'envoi
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            close_websocket(session, 0);
+            return false;
+        }
+        if (n == 0) {
+            close_websocket(session, 0);
+            return false;
+        }
+        session->input.append(buffer, n);
+    }
+
+    size_t offset = 0;
+    while (offset < session->input.size()) {
+        WebSocketFrame frame;
+        size_t consumed = 0;
+        WebSocket::ParseResult result = WebSocket::parse_frame(
+            session->input.data() + offset, session->input.size() - offset, frame, consumed);
+
+        if (result == WebSocket::FRAME_INCOMPLETE) {
             break;
         }
-        
-        total_sent += n;
+        if (result != WebSocket::FRAME_OK) {
+            close_websocket(session, result == WebSocket::FRAME_TOO_LARGE
+                                         ? WebSocket::CLOSE_TOO_LARGE : WebSocket::CLOSE_PROTOCOL_ERROR);
+            return false;
+        }
+
+        offset += consumed;
+        session->touch();
+        if (!handle_ws_frame(session, frame)) {
+            return false;
+        }
+    }
+
+    session->input.erase(0, offset);
+    return true;
+}
+
+bool HttpServer::handle_ws_frame(const std::shared_ptr<WebSocketSession>& session, WebSocketFrame& frame) {
+    switch (frame.opcode) {
+        case WebSocket::TEXT:
+        case WebSocket::BINARY:
+        case WebSocket::CONTINUATION: {
+            bool continuation = frame.opcode == WebSocket::CONTINUATION;
+            if (continuation != (session->message_opcode != 0) ||
+                session->message.size() + frame.payload.size() > WebSocket::MAX_PAYLOAD) {
+                close_websocket(session, WebSocket::CLOSE_PROTOCOL_ERROR);
+                return false;
+            }
+            if (!continuation) {
+                session->message_opcode = frame.opcode;
+            }
+            session->message += frame.payload;
+
+            if (frame.fin) {
+                // Relais explicite (--ws-relay): sinon les messages des clients ne sont diffusés à personne
+                if (config_.ws_relay) {
+                    broadcast(session->message, session->message_opcode == WebSocket::BINARY);
+                }
+                session->message.clear();
+                session->message_opcode = 0;
+            }
+            return true;
+        }
+
+        case WebSocket::PING:
+            session->send(std::make_shared<const std::string>(
+                WebSocket::encode_frame(WebSocket::PONG, frame.payload)));
+            return true;
+
+        case WebSocket::PONG:
+            return true; // touch() a déjà noté l'activité
+
+        case WebSocket::CLOSE:
+            close_websocket(session, WebSocket::CLOSE_NORMAL);
+            return false;
+
+        default:
+            close_websocket(session, WebSocket::CLOSE_PROTOCOL_ERROR);
+            return false;
     }
 }
 
+void HttpServer::close_websocket(const std::shared_ptr<WebSocketSession>& session, uint16_t code) {
+    // Une seule trame CLOSE par session
+    if (code != 0 && !session->close_sent) {
+        session->close_sent = true;
+        session->send(std::make_shared<const std::string>(WebSocket::encode_close(code)));
+    }
+
+    // Le fd a pu être réattribué: ne fermer que la connexion portant cette session
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        auto it = connections_.find(session->fd());
+        if (it == connections_.end() || it->second->ws != session) {
+            return;
+        }
+    }
+    close_connection(session->fd());
+}
+
+void HttpServer::export_traces() {
+    long count = tracer_->export_chrome_trace(config_.trace_file);
+    if (count < 0) {
+        std::cerr << "Erreur: impossible d'écrire " << config_.trace_file << std::endl;
+        return;
+    }
+    std::cout << "Traces: " << count << " requêtes exportées dans " << config_.trace_file << std::endl;
+    tracer_->print_slowest(std::cout, 10);
+}
+
+size_t HttpServer::broadcast(const std::string& message, bool binary) {
+    return ws_hub_.broadcast(message, binary);
+}
+
+void HttpServer::rearm_connection(int client_fd) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+    ev.data.fd = client_fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
+}
+
+void HttpServer::resume_connection(Connection* conn) {
+    // Des enregistrements TLS déjà déchiffrés ne réveilleront pas epoll
+    if (conn->has_buffered_input()) {
+        handle_read(conn->fd);
+    } else {
+        rearm_connection(conn->fd);
+    }
+}
+
+void HttpServer::log_access(const Connection* conn, const HttpRequest& request,
+                            int status, size_t bytes_sent) {
+    if (!access_log_) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - conn->request_start);
+    auto wall = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()) - duration;
+
+    AccessLogRecord record;
+    record.timestamp_us = wall.count();
+    record.duration_us = static_cast<uint32_t>(duration.count());
+    record.client_ip = conn->address.sin_addr.s_addr;
+    record.bytes_sent = bytes_sent;
+    record.status = static_cast<uint16_t>(status);
+    RecordFormat::copy_field(record.method, request.method.empty() ? "-" : request.method);
+    RecordFormat::copy_field(record.protocol, request.version.empty() ? "-" : request.version);
+    RecordFormat::copy_field(record.path, request.path.empty() ? "-" : request.path);
+    access_log_->log(record);
+}
+
+void HttpServer::send_error(Connection* conn, HttpRequest request, HttpResponse::StatusCode status,
+                            const std::string& body) {
+    request.keep_alive = false;
+    ResponseWriter writer(conn, request);
+    writer.set_status(status);
+    writer.write(body);
+    writer.finish();
+    continue_response(std::make_unique<ResponseStream>(conn, std::move(request), std::move(writer)));
+}
+
 void HttpServer::close_connection(int client_fd) {
     std::lock_guard<std::mutex> lock(connections_mutex_);
     // Retirer de epoll (ignore les erreurs si déjà fermé)
     epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, client_fd, nullptr);
+
+    // Désabonner la session WebSocket avant la fermeture du fd
+    auto it = connections_.find(client_fd);
+    if (it != connections_.end() && it->second->ws) {
+        ws_hub_.unsubscribe(it->second->ws);
+        it->second->ws->close();
+    }
+
+    // Envois zero-copy non confirmés: le noyau lit encore les buffers. Le socket reste
+    // ouvert (FIN envoyé) pour recevoir les notifications, et les buffers vivants
+    if (it != connections_.end() && it->second->zerocopy) {
+        Connection& conn = *it->second;
+        conn.zerocopy->drain(client_fd);
+        if (!conn.zerocopy->idle()) {
+            ::shutdown(client_fd, SHUT_WR);
+            std::lock_guard<std::mutex> orphans_lock(zerocopy_orphans_mutex_);
+            zerocopy_orphans_.push_back({client_fd, std::move(conn.zerocopy),
+                                         WebSocketHub::now_ms() + ZEROCOPY_ORPHAN_TIMEOUT_MS});
+            conn.fd = -1;
+        }
+    }
+
+    // Réponse garée sur ce fd: abandonnée avec la connexion
+    {
+        std::lock_guard<std::mutex> parked_lock(parked_responses_mutex_);
+        parked_responses_.erase(client_fd);
+    }
     connections_.erase(client_fd);
 }
 
+void HttpServer::handle_error(int client_fd, uint32_t events) {
+    thread_pool_->enqueue([this, client_fd, events]() {
+        // Réponse garée: l'envoi constate lui-même l'erreur, ou repart (notification zero-copy)
+        std::unique_ptr<ResponseStream> stream;
+        bool parked = claim_parked_response(client_fd, stream);
+        if (stream) {
+            continue_response(std::move(stream));
+            return;
+        }
+
+        Connection* conn = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            auto it = connections_.find(client_fd);
+            if (it == connections_.end() || it->second->ws) {
+                return; // Le lecteur WebSocket verra l'erreur à sa prochaine lecture
+            }
+            conn = it->second.get();
+        }
+        if (parked) {
+            send_h2_output(conn);
+            return;
+        }
+
+        if (conn->zerocopy) {
+            conn->zerocopy->drain(client_fd);
+        }
+
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(client_fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if (error != 0 || (events & EPOLLHUP)) {
+            close_connection(client_fd);
+            return;
+        }
+
+        // Notifications consommées: la connexion attend sa prochaine requête
+        rearm_connection(client_fd);
+    });
+}
+
+void HttpServer::reap_zerocopy_orphans(bool force) {
+    std::lock_guard<std::mutex> lock(zerocopy_orphans_mutex_);
+    int64_t now = WebSocketHub::now_ms();
+    for (size_t i = 0; i < zerocopy_orphans_.size();) {
+        ZeroCopyOrphan& orphan = zerocopy_orphans_[i];
+        orphan.sender->drain(orphan.fd);
+        if (force || orphan.sender->idle() || now >= orphan.deadline_ms) {
+            ::close(orphan.fd);
+            zerocopy_orphans_[i] = std::move(zerocopy_orphans_.back());
+            zerocopy_orphans_.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void HttpServer::queue_segmented(ResponseWriter& writer, const SegmentedResponse& response) {
+    writer.set_status(response.status);
+    for (const auto& header : response.headers) {
+        writer.set_header(header.first, header.second);
+    }
+    for (const auto& segment : response.body) {
+        writer.write_segment(segment);
+    }
+    writer.finish();
+}
+
+void HttpServer::continue_response(std::unique_ptr<ResponseStream> stream) {
+    ResponseWriter& writer = stream->writer;
+    const size_t start = writer.bytes_sent();
+    std::string chunk;
+
+    while (true) {
+        ResponseWriter::SendResult result = writer.send();
+        if (result == ResponseWriter::SEND_FAILED || (result == ResponseWriter::SEND_DONE && writer.finished())) {
+            finish_response(std::move(stream));
+            return;
+        }
+        // Socket plein, ou part de ce passage épuisée: les autres connexions passent d'abord
+        if (result == ResponseWriter::SEND_BLOCKED || writer.bytes_sent() - start >= RESPONSE_SLICE_BYTES) {
+            // fd lu avant l'appel: l'ordre d'évaluation des arguments n'est pas garanti
+            const int client_fd = stream->conn->fd;
+            park_response(client_fd, std::move(stream));
+            return;
+        }
+
+        // File vide: produire la suite du corps
+        try {
+            bool more = true;
+            while (more && !writer.failed() && writer.queued_bytes() < ResponseWriter::BUFFER_SIZE) {
+                chunk.clear();
+                more = stream->produce(chunk);
+                writer.write(chunk);
+            }
+            if (!more) {
+                writer.finish();
+                if (stream->traced) {
+                    stream->trace.handler_ns = RequestTracer::now_ns();
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur pendant une réponse en flux: " << e.what() << std::endl;
+            if (writer.started()) {
+                // En-têtes déjà partis: seule la fermeture signale au client un corps incomplet
+                finish_response(std::move(stream));
+                return;
+            }
+            // Rien d'envoyé: réponse 500 classique
+            writer = ResponseWriter(stream->conn, stream->request);
+            writer.set_status(HttpResponse::INTERNAL_ERROR);
+            writer.write("<html><body><h1>500 Internal Server Error</h1><p>Une erreur interne s'est produite.</p></body></html>");
+            writer.finish();
+            stream->produce = nullptr;
+        }
+    }
+}
+
+void HttpServer::finish_response(std::unique_ptr<ResponseStream> stream) {
+    Connection* conn = stream->conn;
+    const ResponseWriter& writer = stream->writer;
+    log_access(conn, stream->request, writer.status(), writer.bytes_sent());
+
+    ++conn->request_count;
+    if (stream->traced) {
+        RequestTrace& trace = stream->trace;
+        trace.send_ns = RequestTracer::now_ns();
+        if (trace.handler_ns == 0) {
+            trace.handler_ns = trace.send_ns; // Production interrompue (erreur, client parti)
+        }
+        trace.status = static_cast<uint16_t>(writer.status());
+        RecordFormat::copy_field(trace.method, stream->request.method);
+        RecordFormat::copy_field(trace.path, stream->request.path);
+        tracer_->record(trace);
+    }
+
+    // Gérer keep-alive (la connexion appartient à ce worker tant qu'epoll n'est pas réarmé;
+    // close_connection prend connections_mutex_, il ne doit pas être appelé sous ce verrou)
+    const bool keep_alive = writer.finished() && writer.keep_alive();
+    conn->keep_alive = keep_alive;
+    conn->reset();
+
+    if (keep_alive) {
+        // Réactiver epoll pour cette connexion
+        resume_connection(conn);
+    } else {
+        close_connection(conn->fd);
+    }
+}
+
+void HttpServer::park_response(int client_fd, std::unique_ptr<ResponseStream> stream) {
+    {
+        std::lock_guard<std::mutex> lock(parked_responses_mutex_);
+        parked_responses_[client_fd] = {std::move(stream), WebSocketHub::now_ms() + ResponseWriter::WRITE_TIMEOUT_MS};
+    }
+
+    // Enregistrée avant d'armer epoll: l'événement peut arriver immédiatement
+    struct epoll_event ev;
+    ev.events = EPOLLOUT | EPOLLET | EPOLLONESHOT;
+    ev.data.fd = client_fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client_fd, &ev);
+}
+
+bool HttpServer::claim_parked_response(int client_fd, std::unique_ptr<ResponseStream>& stream) {
+    std::lock_guard<std::mutex> lock(parked_responses_mutex_);
+    auto it = parked_responses_.find(client_fd);
+    if (it == parked_responses_.end()) {
+        return false;
+    }
+    stream = std::move(it->second.stream);
+    parked_responses_.erase(it);
+    return true;
+}
+
+void HttpServer::expire_parked_responses() {
+    std::vector<std::pair<int, std::unique_ptr<ResponseStream>>> expired;
+    {
+        std::lock_guard<std::mutex> lock(parked_responses_mutex_);
+        int64_t now = WebSocketHub::now_ms();
+        for (auto it = parked_responses_.begin(); it != parked_responses_.end();) {
+            if (now >= it->second.deadline_ms) {
+                expired.emplace_back(it->first, std::move(it->second.stream));
+                it = parked_responses_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Client qui ne lit plus: la réponse est abandonnée
+    for (auto& entry : expired) {
+        const auto& stream = entry.second;
+        if (stream) {
+            log_access(stream->conn, stream->request, stream->writer.status(), stream->writer.bytes_sent());
+        }
+        close_connection(entry.first);
+    }
+}
+
+bool HttpServer::stream_route(const HttpRequest& request, StreamedResponse& response) {
+    if (!config_.bench_routes || request.method != "GET" || request.path.compare(0, 8, "/stream/") != 0) {
+        return false;
+    }
+
+    // /stream/N: N octets produits par morceaux de 16 Ko, chunked (ou ?length: Content-Length)
+    size_t size = std::strtoull(request.path.c_str() + 8, nullptr, 10);
+    if (size == 0 || size > MAX_STREAMED_BYTES) {
+        return false;
+    }
+    if (request.path.find("?length") != std::string::npos) {
+        response.has_length = true;
+        response.content_length = size;
+    }
+    response.headers.emplace_back("Content-Type", "text/plain; charset=utf-8");
+
+    response.produce = [size, offset = size_t(0)](std::string& chunk) mutable {
+        size_t len = std::min<size_t>(16 * 1024, size - offset);
+        chunk.resize(len);
+        for (size_t i = 0; i < len; ++i) {
+            chunk[i] = static_cast<char>('a' + (offset + i) % 26);
+        }
+        offset += len;
+        return offset < size;
+    };
+    return true;
+}
+
+bool HttpServer::serve_static(const HttpRequest& request, SegmentedResponse& response) {
+    if (!file_cache_ || (request.method != "GET" && request.method != "HEAD")) {
+        return false;
+    }
+
+    std::shared_ptr<const FileDescriptor> disk;
+    std::shared_ptr<const CachedFile> file = file_cache_->lookup(request.path, disk);
+    if (!file) {
+        return false; // Routes générées, puis 404
+    }
+
+    HttpConditional::build_response(request, file, disk, response);
+    return true;
+}
+
 std::string HttpServer::generate_response(const HttpRequest& request) {
     // Support GET seulement pour l'instant
     if (request.method != "GET") {
         return ""; // Sera géré comme 405 dans process_request
     }
 
+    // Corps généré de N octets (mesure des envois volumineux, --zerocopy-threshold), si --bench-routes
+    if (config_.bench_routes && request.path.compare(0, 7, "/bytes/") == 0) {
+        size_t size = std::strtoull(request.path.c_str() + 7, nullptr, 10);
+        if (size == 0 || size > MAX_GENERATED_BYTES) {
+            return "";
+        }
+        std::string body(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            body[i] = static_cast<char>('a' + i % 26);
+        }
+        return body;
+    }
+
     // Route simple
     if (request.path == "/" || request.path == "/index.html") {
         std::ostringstream oss;
@@ -353,10 +1269,15 @@ void HttpServer::start() {
         return;
     }
 
+    if (access_log_ && !access_log_->start()) {
+        return;
+    }
+
     running_ = true;
     
     // Lancer la boucle principale dans un thread dédié
     std::thread main_loop([this]() {
+        pin_reactor_thread();
         handle_epoll_events();
     });
 
@@ -373,8 +1294,13 @@ void HttpServer::stop() {
     running_ = false;
 
     // Fermer toutes les connexions
+    ws_hub_.close_all();
     {
         std::lock_guard<std::mutex> lock(connections_mutex_);
+        {
+            std::lock_guard<std::mutex> parked_lock(parked_responses_mutex_);
+            parked_responses_.clear();
+        }
         connections_.clear();
     }
 
@@ -388,7 +1314,30 @@ void HttpServer::stop() {
         server_fd_ = -1;
     }
 
+    if (tls_server_fd_ >= 0) {
+        ::close(tls_server_fd_);
+        tls_server_fd_ = -1;
+    }
+
     thread_pool_->shutdown();
+    reap_zerocopy_orphans(true);
+
+    if (config_.zerocopy_threshold > 0) {
+        ZeroCopySender::Stats& stats = ZeroCopySender::stats();
+        std::cout << "Zero-copy: " << stats.sends.load() << " envois (" << stats.bytes.load()
+                  << " octets), " << stats.completions.load() << " confirmés dont "
+                  << stats.copied.load() << " recopiés par le noyau, "
+                  << stats.fallbacks.load() << " replis ENOBUFS" << std::endl;
+    }
+
+    // Après l'arrêt des workers: plus aucun producteur
+    if (access_log_) {
+        access_log_->stop();
+        if (access_log_->dropped() > 0) {
+            std::cout << "Access log: " << access_log_->dropped()
+                      << " enregistrements abandonnés" << std::endl;
+        }
+    }
     
     std::cout << "Serveur arrêté." << std::endl;
 }
@@ -4,11 +4,22 @@
 #include "Connection.h"
 #include "HttpRequest.h"
 #include "HttpResponse.h"
+#include "ServerConfig.h"
+#include "AccessLog.h"
+#include "FileCache.h"
+#include "ResponseWriter.h"
+#include "RequestTracer.h"
+#include "Http2Session.h"
+#include "WebSocket.h"
+#include "WebSocketHub.h"
 #include <sys/epoll.h>
 #include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
+
+class TlsContext;
 
 /**
  * Serveur HTTP haute performance utilisant epoll et ThreadPool
@@ -17,6 +28,7 @@
 class HttpServer {
 public:
     HttpServer(int port, size_t thread_pool_size = 4, size_t max_connections = 10000);
+    explicit HttpServer(const ServerConfig& config);
     ~HttpServer();
 
     // Non-copyable, non-movable
@@ -31,38 +43,171 @@ public:
     // Arrêter le serveur
     void stop();
 
+    // Diffuser un message à tous les clients WebSocket; retourne le nombre de destinataires
+    size_t broadcast(const std::string& message, bool binary = false);
+
+    // Demander l'export des traces (utilisable depuis un handler de signal)
+    void request_trace_export() { trace_export_requested_.store(true, std::memory_order_relaxed); }
+
 private:
+    ServerConfig config_;
     int port_;
     int server_fd_;
+    int tls_server_fd_;                     // Écoute HTTPS, -1 si désactivée
     int epoll_fd_;
     std::atomic<bool> running_;
     std::unique_ptr<ThreadPool> thread_pool_;
+    std::unique_ptr<AccessLog> access_log_;
+    std::unique_ptr<FileCache> file_cache_;    // Fichiers statiques (--root), nullptr si désactivé
+    std::unique_ptr<RequestTracer> tracer_;    // Traçage échantillonné, nullptr si désactivé
+    std::atomic<bool> trace_export_requested_{false};
+    WebSocketHub ws_hub_;
+#ifdef HTTP_SERVER_TLS
+    std::unique_ptr<TlsContext> tls_context_;
+#endif
     size_t max_connections_;
     
     // Gestion des connexions
     std::unordered_map<int, std::unique_ptr<Connection>> connections_;
     std::mutex connections_mutex_;
 
-    // Initialiser le socket serveur
+    // Sockets fermés dont des envois MSG_ZEROCOPY attendent encore leur notification
+    struct ZeroCopyOrphan {
+        int fd;
+        std::unique_ptr<ZeroCopySender> sender;
+        int64_t deadline_ms;
+    };
+    std::vector<ZeroCopyOrphan> zerocopy_orphans_;
+    std::mutex zerocopy_orphans_mutex_;
+
+    // Réponse HTTP/1.x en cours d'envoi
+    struct ResponseStream {
+        ResponseStream(Connection* connection, HttpRequest&& req, ResponseWriter&& response_writer)
+            : conn(connection), request(std::move(req)), writer(std::move(response_writer)) {}
+
+        Connection* conn;
+        HttpRequest request;                    // Access log et trace en fin de réponse
+        ResponseWriter writer;
+        StreamedResponse::Producer produce;     // Suite du corps, vide si tout est déjà en file
+        RequestTrace trace;
+        bool traced = false;
+    };
+
+    // Réponses en attente d'EPOLLOUT (socket plein ou part du worker épuisée);
+    // la tâche qui retire l'entrée devient seule détentrice de la connexion.
+    // stream est vide pour une connexion HTTP/2 (sortie dans Connection::h2_output)
+    struct ParkedResponse {
+        std::unique_ptr<ResponseStream> stream;
+        int64_t deadline_ms;
+    };
+    std::unordered_map<int, ParkedResponse> parked_responses_;
+    std::mutex parked_responses_mutex_;
+
+    // Taille maximale des corps générés par /bytes/N et /stream/N
+    static constexpr size_t MAX_GENERATED_BYTES = 64 * 1024 * 1024;
+    static constexpr size_t MAX_STREAMED_BYTES = 1024ULL * 1024 * 1024;
+
+    // Initialiser les sockets serveur (HTTP et, si configuré, HTTPS)
     bool setup_server_socket();
+
+    // Créer un socket d'écoute non bloquant sur un port
+    int open_listener(int port);
     
+    // Appliquer le placement CPU/NUMA au thread epoll
+    void pin_reactor_thread();
+
     // Configurer epoll
     bool setup_epoll();
     
-    // Accepter une nouvelle connexion
-    void accept_connection();
+    // Accepter les nouvelles connexions d'un socket d'écoute
+    void accept_connection(int listen_fd);
     
     // Gérer les événements epoll
     void handle_epoll_events();
     
     // Lire les données d'une connexion
     void handle_read(int client_fd);
+
+    // Socket de nouveau inscriptible (files WebSocket, poignée de main TLS)
+    void handle_write(int client_fd);
+
+    // EPOLLERR/EPOLLHUP seuls: notifications MSG_ZEROCOPY ou erreur du socket
+    void handle_error(int client_fd, uint32_t events);
+
+    // Fermer les sockets orphelins confirmés ou expirés (tous si force)
+    void reap_zerocopy_orphans(bool force);
+
+    // Faire avancer la poignée de main TLS; true si la connexion est établie
+    bool advance_tls_handshake(Connection* conn);
     
-    // Traiter une requête HTTP
-    void process_request(int client_fd, const std::string& request_data);
+    // Traiter une requête HTTP (trace non nulle si la requête est échantillonnée)
+    void process_request(Connection* conn, const std::string& request_data, RequestTrace* trace = nullptr);
+
+    // Écrire le fichier Chrome trace et résumer les requêtes les plus lentes
+    void export_traces();
+
+    // Enregistrer une requête servie dans l'access log
+    void log_access(const Connection* conn, const HttpRequest& request, int status, size_t bytes_sent);
     
-    // Envoyer une réponse
-    void send_response(int client_fd, const std::string& response);
+    // Router une requête vers les handlers (commun à HTTP/1.1 et HTTP/2)
+    HttpResponse::StatusCode route_request(const HttpRequest& request, std::string& response_body);
+
+    // Basculer en HTTP/2 si la requête demande Upgrade: h2c
+    bool try_upgrade_h2c(Connection* conn, const HttpRequest& request);
+
+    // Handler des flux HTTP/2 d'une connexion
+    Http2Session::Handler make_h2_handler(Connection* conn);
+
+    // Transmettre des octets reçus à la session HTTP/2 et envoyer ses trames
+    void process_h2_data(Connection* conn, const char* data, size_t len);
+
+    // Envoyer conn->h2_output sans bloquer, puis la suite des réponses arrêtées sur
+    // Http2Session::MAX_OUTPUT; garer la connexion quand le socket est plein
+    void send_h2_output(Connection* conn);
+
+    // Basculer en WebSocket si la requête vise /ws avec Upgrade: websocket
+    bool try_upgrade_websocket(Connection* conn, const HttpRequest& request);
+
+    // Lire et traiter les trames d'une session WebSocket
+    void handle_ws_read(const std::shared_ptr<WebSocketSession>& session);
+    bool drain_websocket(const std::shared_ptr<WebSocketSession>& session);
+    bool handle_ws_frame(const std::shared_ptr<WebSocketSession>& session, WebSocketFrame& frame);
+    void close_websocket(const std::shared_ptr<WebSocketSession>& session, uint16_t code);
+
+    // Réactiver epoll (EPOLLONESHOT) pour une connexion
+    void rearm_connection(int client_fd);
+
+    // Réarmer epoll, ou relancer la lecture si OpenSSL garde des octets déchiffrés
+    void resume_connection(Connection* conn);
+
+    // Réponse d'erreur suivie de la fermeture, envoyée sans bloquer comme les autres réponses
+    void send_error(Connection* conn, HttpRequest request, HttpResponse::StatusCode status,
+                    const std::string& body);
+
+    // Mettre en file une réponse segmentée (fichier statique)
+    static void queue_segmented(ResponseWriter& writer, const SegmentedResponse& response);
+
+    // Envoyer sans bloquer et produire la suite du corps; garer la réponse quand le socket est plein
+    void continue_response(std::unique_ptr<ResponseStream> stream);
+
+    // Réponse terminée ou abandonnée: access log, trace, keep-alive
+    void finish_response(std::unique_ptr<ResponseStream> stream);
+
+    // Attendre EPOLLOUT pour reprendre la réponse (sans stream: sortie HTTP/2 de la connexion)
+    void park_response(int client_fd, std::unique_ptr<ResponseStream> stream);
+
+    // Retirer la réponse garée d'une connexion; false si aucune (déjà reprise ou expirée).
+    // Un stream vide désigne la sortie HTTP/2 en attente
+    bool claim_parked_response(int client_fd, std::unique_ptr<ResponseStream>& stream);
+
+    // Fermer les connexions dont la réponse n'avance plus depuis WRITE_TIMEOUT_MS (sur un worker)
+    void expire_parked_responses();
+
+    // Routes produisant leur corps par morceaux (commun à HTTP/1.1 et HTTP/2), si --bench-routes
+    bool stream_route(const HttpRequest& request, StreamedResponse& response);
+
+    // Servir un GET/HEAD depuis la racine statique; false si aucun fichier ne correspond
+    bool serve_static(const HttpRequest& request, SegmentedResponse& response);
     
     // Fermer une connexion
     void close_connection(int client_fd);
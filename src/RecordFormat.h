@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Champs texte de taille fixe des enregistrements binaires (access log,
+ * traces) et leur écriture dans une chaîne JSON
+ */
+class RecordFormat {
+public:
+    // Copier une chaîne dans un champ de taille fixe (tronquée, terminée par \0)
+    template<size_t N>
+    static void copy_field(char (&field)[N], const std::string& value) {
+        size_t len = value.size() < N - 1 ? value.size() : N - 1;
+        value.copy(field, len);
+        field[len] = '\0';
+    }
+
+    // Contenu d'une chaîne JSON ou d'un champ entre guillemets de l'access log, sans
+    // les guillemets (", \ et caractères de contrôle échappés)
+    static void append_json_string(std::string& out, const char* value);
+};
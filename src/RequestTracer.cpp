@@ -0,0 +1,195 @@
+#include "RequestTracer.h"
+#include "RecordFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+namespace {
+
+// xorshift64 par thread pour l'échantillonnage
+uint32_t next_random() {
+    thread_local uint64_t state = 0;
+    if (state == 0) {
+        state = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                reinterpret_cast<uintptr_t>(&state) ^ 0x9e3779b97f4a7c15ULL;
+    }
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<uint32_t>(state >> 32);
+}
+
+struct Phase {
+    const char* name;
+    int64_t start;
+    int64_t end;
+};
+
+// Phases mesurées d'une trace, dans l'ordre
+std::vector<Phase> phases_of(const RequestTrace& trace) {
+    std::vector<Phase> phases;
+    if (trace.accept_ns) {
+        phases.push_back({"accept", trace.accept_ns, trace.enqueue_ns});
+    }
+    phases.push_back({"queue", trace.enqueue_ns, trace.dequeue_ns});
+    phases.push_back({"recv", trace.dequeue_ns, trace.recv_ns});
+    phases.push_back({"parse", trace.recv_ns, trace.parse_ns});
+    phases.push_back({"handler", trace.parse_ns, trace.handler_ns});
+    phases.push_back({"send", trace.handler_ns, trace.send_ns});
+    return phases;
+}
+
+// Horodatage Chrome trace: microsecondes
+void append_us(std::string& out, int64_t ns) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                  static_cast<long long>(ns % 1000));
+    out += buffer;
+}
+
+} // namespace
+
+RequestTracer::RequestTracer(double sample_rate, size_t max_threads, size_t per_thread_capacity)
+    : sample_threshold_(static_cast<uint64_t>(std::min(1.0, std::max(0.0, sample_rate)) * 4294967296.0)) {
+    buffers_.reserve(max_threads);
+    for (size_t i = 0; i < max_threads; ++i) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->traces.resize(per_thread_capacity);
+        buffers_.push_back(std::move(buffer));
+    }
+}
+
+int64_t RequestTracer::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool RequestTracer::should_sample() const {
+    return sample_threshold_ > 0 && next_random() < sample_threshold_;
+}
+
+uint32_t RequestTracer::thread_index() {
+    return static_cast<uint32_t>(slot_.index());
+}
+
+RequestTracer::ThreadBuffer* RequestTracer::thread_buffer() {
+    size_t slot = slot_.index();
+    return slot < buffers_.size() ? buffers_[slot].get() : nullptr;
+}
+
+void RequestTracer::record(const RequestTrace& trace) {
+    ThreadBuffer* buffer = thread_buffer();
+    if (!buffer || buffer->traces.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->traces[buffer->next] = trace;
+    buffer->next = (buffer->next + 1) % buffer->traces.size();
+    buffer->count = std::min(buffer->count + 1, buffer->traces.size());
+}
+
+std::vector<RequestTrace> RequestTracer::snapshot() const {
+    std::vector<RequestTrace> traces;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        size_t capacity = buffer->traces.size();
+        size_t first = (buffer->next + capacity - buffer->count) % capacity;
+        for (size_t i = 0; i < buffer->count; ++i) {
+            traces.push_back(buffer->traces[(first + i) % capacity]);
+        }
+    }
+    std::sort(traces.begin(), traces.end(), [](const RequestTrace& a, const RequestTrace& b) {
+        return a.enqueue_ns < b.enqueue_ns;
+    });
+    return traces;
+}
+
+long RequestTracer::export_chrome_trace(const std::string& path) const {
+    std::vector<RequestTrace> traces = snapshot();
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first_event = true;
+    auto begin_event = [&json, &first_event]() {
+        if (!first_event) {
+            json += ",\n";
+        }
+        first_event = false;
+    };
+
+    // Noms des pistes: une par worker
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        begin_event();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(i + 1) +
+                ",\"args\":{\"name\":\"worker " + std::to_string(i) + "\"}}";
+    }
+
+    uint64_t id = 0;
+    for (const RequestTrace& trace : traces) {
+        ++id;
+        std::string args = "{\"id\":" + std::to_string(id) + ",\"method\":\"";
+        RecordFormat::append_json_string(args, trace.method);
+        args += "\",\"path\":\"";
+        RecordFormat::append_json_string(args, trace.path);
+        args += "\",\"status\":" + std::to_string(trace.status) + "}";
+        const std::string tid = std::to_string(trace.thread + 1);
+
+        for (const Phase& phase : phases_of(trace)) {
+            begin_event();
+            if (std::strcmp(phase.name, "accept") == 0 || std::strcmp(phase.name, "queue") == 0) {
+                // Attentes hors worker: événements asynchrones (une ligne par requête)
+                json += "{\"name\":\"" + std::string(phase.name) + "\",\"cat\":\"wait\",\"ph\":\"b\",\"pid\":1,\"tid\":" +
+                        tid + ",\"id\":" + std::to_string(id) + ",\"ts\":";
+                append_us(json, phase.start);
+                json += ",\"args\":" + args + "},\n";
+                json += "{\"name\":\"" + std::string(phase.name) + "\",\"cat\":\"wait\",\"ph\":\"e\",\"pid\":1,\"tid\":" +
+                        tid + ",\"id\":" + std::to_string(id) + ",\"ts\":";
+                append_us(json, phase.end);
+                json += "}";
+            } else {
+                json += "{\"name\":\"" + std::string(phase.name) + "\",\"cat\":\"request\",\"ph\":\"X\",\"pid\":1,\"tid\":" +
+                        tid + ",\"ts\":";
+                append_us(json, phase.start);
+                json += ",\"dur\":";
+                append_us(json, phase.end - phase.start);
+                json += ",\"args\":" + args + "}";
+            }
+        }
+    }
+    json += "\n]}\n";
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+        return -1;
+    }
+    return static_cast<long>(traces.size());
+}
+
+void RequestTracer::print_slowest(std::ostream& out, size_t n) const {
+    std::vector<RequestTrace> traces = snapshot();
+    if (traces.empty()) {
+        out << "Aucune requête tracée" << std::endl;
+        return;
+    }
+
+    size_t count = std::min(n, traces.size());
+    std::partial_sort(traces.begin(), traces.begin() + count, traces.end(),
+                      [](const RequestTrace& a, const RequestTrace& b) { return a.total_ns() > b.total_ns(); });
+
+    out << "Requêtes les plus lentes (" << count << " sur " << traces.size() << " tracées, µs):" << std::endl;
+    for (size_t i = 0; i < count; ++i) {
+        const RequestTrace& trace = traces[i];
+        char line[256];
+        std::snprintf(line, sizeof(line), "  %10.1f  %-6s %-32s %3u  worker %u  ",
+                      trace.total_ns() / 1000.0, trace.method, trace.path, trace.status, trace.thread);
+        out << line;
+        for (const Phase& phase : phases_of(trace)) {
+            std::snprintf(line, sizeof(line), " %s=%.1f", phase.name, (phase.end - phase.start) / 1000.0);
+            out << line;
+        }
+        out << std::endl;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ThreadSlot.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Horodatages monotones (ns) des phases d'une requête échantillonnée
+ * Une phase à 0 n'a pas été mesurée (ex: accept pour une requête keep-alive).
+ */
+struct RequestTrace {
+    int64_t accept_ns = 0;      // Connexion acceptée (première requête de la connexion)
+    int64_t enqueue_ns = 0;     // EPOLLIN vu par le reactor, tâche ajoutée au ThreadPool
+    int64_t dequeue_ns = 0;     // Tâche prise par un worker
+    int64_t recv_ns = 0;        // Requête complète reçue
+    int64_t parse_ns = 0;       // HttpRequest::parse terminé
+    int64_t handler_ns = 0;     // Corps produit (fin du producteur pour une réponse en flux)
+    int64_t send_ns = 0;        // Réponse envoyée
+    uint32_t thread = 0;        // Index du worker qui a pris la requête (thread_index())
+    uint16_t status = 0;
+    char method[8] = {};
+    char path[64] = {};
+
+    int64_t total_ns() const { return send_ns - (accept_ns ? accept_ns : enqueue_ns); }
+};
+
+/**
+ * Traçage par phase d'une fraction des requêtes
+ * Chaque worker écrit dans son propre buffer circulaire (les plus anciennes
+ * traces sont écrasées); l'export les rassemble au format Chrome trace-event
+ * (chrome://tracing, Perfetto) et résume les requêtes les plus lentes.
+ */
+class RequestTracer {
+public:
+    RequestTracer(double sample_rate, size_t max_threads, size_t per_thread_capacity = 4096);
+
+    // Non-copyable
+    RequestTracer(const RequestTracer&) = delete;
+    RequestTracer& operator=(const RequestTracer&) = delete;
+
+    // Tirage par thread, sans synchronisation
+    bool should_sample() const;
+
+    // Index du thread appelant, attribué au premier appel (piste de l'export)
+    uint32_t thread_index();
+
+    // Dans le buffer du thread appelant, qui peut ne pas être celui de trace.thread
+    // (réponse garée reprise par un autre worker)
+    void record(const RequestTrace& trace);
+
+    // Écrire toutes les traces conservées; retourne le nombre exporté, -1 en cas d'erreur
+    long export_chrome_trace(const std::string& path) const;
+
+    // Les n requêtes les plus lentes avec le détail de leurs phases
+    void print_slowest(std::ostream& out, size_t n) const;
+
+    static int64_t now_ns();
+
+private:
+    struct ThreadBuffer {
+        std::mutex mutex;       // Sans contention hors export
+        std::vector<RequestTrace> traces;
+        size_t next = 0;
+        size_t count = 0;
+    };
+
+    uint64_t sample_threshold_;     // Probabilité * 2^32
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    ThreadSlot<RequestTracer> slot_;
+
+    ThreadBuffer* thread_buffer();
+    std::vector<RequestTrace> snapshot() const;
+};
@@ -0,0 +1,300 @@
+#include "ResponseWriter.h"
+#include "Connection.h"
+#include "FileCache.h"
+#include <strings.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr int MAX_IOV = 64;
+
+// Plage de fichier lue par écriture
+constexpr size_t FILE_BLOCK_SIZE = 64 * 1024;
+
+bool has_header(const HttpResponse::HeaderList& headers, const char* name) {
+    return std::any_of(headers.begin(), headers.end(), [name](const std::pair<std::string, std::string>& header) {
+        return strcasecmp(header.first.c_str(), name) == 0;
+    });
+}
+
+// Délimiteurs partagés par toutes les réponses chunked
+const std::shared_ptr<const std::string>& crlf() {
+    static const auto value = std::make_shared<const std::string>("\r\n");
+    return value;
+}
+
+const std::shared_ptr<const std::string>& last_chunk() {
+    static const auto value = std::make_shared<const std::string>("0\r\n\r\n");
+    return value;
+}
+
+} // namespace
+
+ResponseWriter::ResponseWriter(Connection* conn, const HttpRequest& request, size_t zerocopy_threshold)
+    : conn_(conn), zerocopy_threshold_(zerocopy_threshold), keep_alive_(request.keep_alive),
+      chunked_(request.version == "HTTP/1.1"), head_only_(request.method == "HEAD") {
+}
+
+void ResponseWriter::set_status(HttpResponse::StatusCode status) {
+    status_ = status;
+}
+
+void ResponseWriter::set_header(const std::string& name, const std::string& value) {
+    if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+        set_content_length(std::strtoull(value.c_str(), nullptr, 10));
+        return;
+    }
+    headers_.emplace_back(name, value);
+}
+
+void ResponseWriter::set_content_length(size_t length) {
+    has_length_ = true;
+    content_length_ = length;
+}
+
+bool ResponseWriter::write(const std::string& data) {
+    return write(data.data(), data.size());
+}
+
+bool ResponseWriter::write(const char* data, size_t len) {
+    if (!accept_body(len)) {
+        return false;
+    }
+    if (head_only_) {
+        return true;
+    }
+
+    buffer_.append(data, len);
+    if (buffer_.size() >= BUFFER_SIZE) {
+        flush_buffer();
+    }
+    return true;
+}
+
+bool ResponseWriter::write_segment(const ResponseSegment& segment) {
+    if (!accept_body(segment.length)) {
+        return false;
+    }
+    if (head_only_) {
+        return true;
+    }
+
+    // Conserver l'ordre avec les écritures copiées
+    flush_buffer();
+    queue_body(segment);
+    return true;
+}
+
+bool ResponseWriter::finish() {
+    if (finished_) {
+        return !failed_;
+    }
+    finished_ = true;
+    if (failed_) {
+        return false;
+    }
+
+    // Corps entièrement en buffer: longueur connue, pas de chunk
+    if (!head_queued_ && !has_length_) {
+        has_length_ = true;
+        content_length_ = buffer_.size();
+    }
+
+    flush_buffer();
+    if (!head_queued_) {
+        queue_head();
+    }
+    if (chunked_) {
+        queue_.push_back({last_chunk(), 0, last_chunk()->size(), nullptr});
+        queued_bytes_ += last_chunk()->size();
+    }
+
+    // Corps plus court que la longueur annoncée: le client attendrait la suite
+    if (has_length_ && !head_only_ && body_written_ != content_length_) {
+        failed_ = true;
+    }
+    return !failed_;
+}
+
+ResponseWriter::SendResult ResponseWriter::send() {
+    if (failed_) {
+        return SEND_FAILED;
+    }
+
+    std::vector<ZeroCopySender::Buffer> buffers;
+    while (queue_front_ < queue_.size()) {
+        ssize_t n;
+        if (queue_[queue_front_].file) {
+            n = send_file(queue_[queue_front_]);
+        } else {
+            // Segments en mémoire consécutifs: un seul writev
+            struct iovec iov[MAX_IOV];
+            int count = 0;
+            buffers.clear();
+            for (size_t i = queue_front_; i < queue_.size() && count < MAX_IOV && !queue_[i].file; ++i) {
+                const ResponseSegment& segment = queue_[i];
+                iov[count].iov_base = const_cast<char*>(segment.data->data() + segment.offset);
+                iov[count].iov_len = segment.length;
+                ++count;
+                if (zerocopy_) {
+                    buffers.push_back(segment.data);
+                }
+            }
+
+            // MSG_ZEROCOPY: les segments restent référencés jusqu'aux notifications du noyau
+            n = zerocopy_ ? conn_->zerocopy->send(conn_->fd, iov, count, buffers)
+                          : conn_->writev(iov, count);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Libérer au passage les envois zero-copy terminés
+                if (zerocopy_) {
+                    conn_->zerocopy->drain(conn_->fd);
+                }
+                return SEND_BLOCKED;
+            }
+            failed_ = true;
+            return SEND_FAILED;
+        }
+
+        bytes_sent_ += static_cast<size_t>(n);
+        consume(static_cast<size_t>(n));
+    }
+
+    queue_.clear();
+    queue_front_ = 0;
+    return SEND_DONE;
+}
+
+ssize_t ResponseWriter::send_file(const ResponseSegment& segment) {
+    ssize_t sent = conn_->sendfile(segment.file->get(), segment.offset, segment.length);
+    if (sent == 0) {
+        errno = EIO; // Fichier tronqué pendant l'envoi
+        return -1;
+    }
+    if (sent > 0 || errno != ENOTSUP) {
+        return sent;
+    }
+
+    // TLS en espace utilisateur: bloc relu à chaque tentative, une écriture
+    // interrompue est reprise avec les mêmes octets
+    size_t len = std::min(segment.length, FILE_BLOCK_SIZE);
+    file_buffer_.resize(len);
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::pread(segment.file->get(), &file_buffer_[done], len - done,
+                            static_cast<off_t>(segment.offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            errno = EIO; // Fichier tronqué pendant l'envoi
+            return -1;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return conn_->write(file_buffer_.data(), len);
+}
+
+bool ResponseWriter::accept_body(size_t len) {
+    if (failed_ || finished_) {
+        return false;
+    }
+    if (has_length_ && body_written_ + len > content_length_) {
+        failed_ = true; // Plus d'octets que le Content-Length annoncé
+        return false;
+    }
+    body_written_ += len;
+    return true;
+}
+
+void ResponseWriter::queue_head() {
+    HttpResponse::HeaderList headers = headers_;
+    const bool bodyless = status_ == HttpResponse::NOT_MODIFIED;
+
+    // Framing: longueur annoncée, sinon chunked (HTTP/1.1), sinon fin de connexion (HTTP/1.0)
+    if (bodyless) {
+        chunked_ = false;
+    } else {
+        if (!has_header(headers, "Content-Type")) {
+            headers.emplace_back("Content-Type", HttpResponse::DEFAULT_CONTENT_TYPE);
+        }
+        if (has_length_) {
+            chunked_ = false;
+            headers.emplace_back("Content-Length", std::to_string(content_length_));
+        } else if (chunked_) {
+            headers.emplace_back("Transfer-Encoding", "chunked");
+        } else {
+            keep_alive_ = false;
+        }
+    }
+    if (head_only_) {
+        chunked_ = false;
+    }
+
+    zerocopy_ = conn_->zerocopy && zerocopy_threshold_ > 0 && has_length_ && !head_only_ &&
+                content_length_ >= zerocopy_threshold_;
+    queue_string(HttpResponse::build_head(status_, headers, keep_alive_));
+    head_queued_ = true;
+}
+
+void ResponseWriter::queue_body(const ResponseSegment& segment) {
+    if (segment.length == 0) {
+        return;
+    }
+    if (!head_queued_) {
+        queue_head();
+    }
+
+    if (!chunked_) {
+        queue_.push_back(segment);
+        queued_bytes_ += segment.length;
+        return;
+    }
+
+    // Un chunk: taille en hexadécimal, données, CRLF
+    char size_line[24];
+    std::snprintf(size_line, sizeof(size_line), "%zx\r\n", segment.length);
+    queue_string(size_line);
+    queue_.push_back(segment);
+    queue_.push_back({crlf(), 0, crlf()->size(), nullptr});
+    queued_bytes_ += segment.length + crlf()->size();
+}
+
+void ResponseWriter::queue_string(std::string data) {
+    size_t len = data.size();
+    queue_.push_back({std::make_shared<const std::string>(std::move(data)), 0, len, nullptr});
+    queued_bytes_ += len;
+}
+
+void ResponseWriter::flush_buffer() {
+    if (buffer_.empty()) {
+        return;
+    }
+    auto data = std::make_shared<const std::string>(std::move(buffer_));
+    buffer_.clear();
+    queue_body({data, 0, data->size(), nullptr});
+}
+
+void ResponseWriter::consume(size_t sent) {
+    queued_bytes_ -= sent;
+    while (sent > 0) {
+        ResponseSegment& segment = queue_[queue_front_];
+        if (sent < segment.length) {
+            segment.offset += sent;
+            segment.length -= sent;
+            return;
+        }
+        sent -= segment.length;
+        segment.data.reset();
+        segment.file.reset();
+        ++queue_front_;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Connection;
+
+/**
+ * Envoi non bloquant d'une réponse HTTP/1.x
+ * Les en-têtes, le framing (Content-Length, Transfer-Encoding: chunked ou
+ * fermeture en HTTP/1.0) et le corps sont mis en file sous forme de segments
+ * partagés; send() en écrit autant que le socket en accepte. Quand le socket
+ * est plein, la réponse reste en file et l'appelant la reprend sur EPOLLOUT:
+ * un client lent ne bloque jamais le worker.
+ */
+class ResponseWriter {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;    // Regroupement des petites écritures
+    static constexpr int WRITE_TIMEOUT_MS = 30000;      // Client sans progrès: abandon
+
+    enum SendResult {
+        SEND_DONE,          // File vide
+        SEND_BLOCKED,       // Socket plein: reprendre sur EPOLLOUT
+        SEND_FAILED         // Client parti ou longueur annoncée dépassée
+    };
+
+    // Les corps d'au moins zerocopy_threshold octets partent en MSG_ZEROCOPY si la connexion l'a activé
+    ResponseWriter(Connection* conn, const HttpRequest& request, size_t zerocopy_threshold = 0);
+
+    // Non-copyable, movable
+    ResponseWriter(const ResponseWriter&) = delete;
+    ResponseWriter& operator=(const ResponseWriter&) = delete;
+    ResponseWriter(ResponseWriter&&) = default;
+    ResponseWriter& operator=(ResponseWriter&&) = default;
+
+    // Avant le premier octet de corps (Content-Length fixe la longueur annoncée)
+    void set_status(HttpResponse::StatusCode status);
+    void set_header(const std::string& name, const std::string& value);
+    void set_content_length(size_t length);
+
+    // Corps copié et regroupé en morceaux de BUFFER_SIZE
+    bool write(const char* data, size_t len);
+    bool write(const std::string& data);
+
+    // Tranche d'un buffer partagé (ou plage de fichier), mise en file sans copie
+    bool write_segment(const ResponseSegment& segment);
+
+    // Terminer le corps (dernier chunk); une réponse encore entièrement en
+    // buffer part avec un Content-Length
+    bool finish();
+
+    // Écrire la file sur le socket sans attendre
+    SendResult send();
+
+    HttpResponse::StatusCode status() const { return status_; }
+    const HttpResponse::HeaderList& headers() const { return headers_; }
+    bool started() const { return head_queued_; }
+    bool finished() const { return finished_; }
+    bool failed() const { return failed_; }
+
+    // La connexion peut-elle servir une autre requête après cette réponse
+    bool keep_alive() const { return keep_alive_ && !failed_; }
+
+    // Octets en file, pas encore acceptés par le socket
+    size_t queued_bytes() const { return queued_bytes_; }
+
+    // Octets écrits sur le socket (en-têtes et framing compris)
+    size_t bytes_sent() const { return bytes_sent_; }
+
+private:
+    Connection* conn_;
+    HttpResponse::StatusCode status_ = HttpResponse::OK;
+    HttpResponse::HeaderList headers_;
+    std::string buffer_;
+    std::string file_buffer_;           // Bloc de fichier en cours d'écriture
+    std::vector<ResponseSegment> queue_;
+    size_t queue_front_ = 0;
+    size_t queued_bytes_ = 0;
+    size_t zerocopy_threshold_;
+    bool keep_alive_;
+    bool chunked_;
+    bool head_only_;                // HEAD: en-têtes seuls
+    bool has_length_ = false;
+    size_t content_length_ = 0;
+    size_t body_written_ = 0;
+    size_t bytes_sent_ = 0;
+    bool head_queued_ = false;
+    bool zerocopy_ = false;
+    bool finished_ = false;
+    bool failed_ = false;
+
+    bool accept_body(size_t len);
+    void queue_head();
+    void queue_body(const ResponseSegment& segment);
+    void queue_string(std::string data);
+    void flush_buffer();
+    void consume(size_t sent);
+    ssize_t send_file(const ResponseSegment& segment);
+};
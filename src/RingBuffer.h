@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * Ring buffer lock-free un producteur / un consommateur
+ * Capacité arrondie à la puissance de deux supérieure
+ */
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity);
+
+    // Non-copyable, non-movable
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Côté producteur: false si le buffer est plein
+    bool try_push(const T& item);
+
+    // Côté consommateur: false si le buffer est vide
+    bool try_pop(T& item);
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Indices sur des lignes de cache distinctes pour éviter le false sharing
+    alignas(CACHE_LINE) std::atomic<size_t> head_{0};   // Écrit par le consommateur
+    alignas(CACHE_LINE) size_t cached_tail_ = 0;        // Copie locale du consommateur
+    alignas(CACHE_LINE) std::atomic<size_t> tail_{0};   // Écrit par le producteur
+    alignas(CACHE_LINE) size_t cached_head_ = 0;        // Copie locale du producteur
+};
+
+template<typename T>
+SpscRing<T>::SpscRing(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_ = std::make_unique<T[]>(size);
+}
+
+template<typename T>
+bool SpscRing<T>::try_push(const T& item) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ > mask_) {
+            return false;
+        }
+    }
+    slots_[tail & mask_] = item;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+bool SpscRing<T>::try_pop(T& item) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head == cached_tail_) {
+            return false;
+        }
+    }
+    item = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
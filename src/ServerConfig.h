@@ -0,0 +1,62 @@
+#pragma once
+
+#include "SocketTuning.h"
+#include "AccessLog.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Configuration du serveur (placement CPU/NUMA et réglages réseau)
+ */
+struct ServerConfig {
+    int port = 8080;
+    size_t thread_pool_size = std::thread::hardware_concurrency();
+    size_t max_connections = 10000;
+
+    // Placement des threads
+    int reactor_cpu = -1;               // CPU du thread epoll, -1 = non épinglé
+    std::vector<int> worker_cpus;       // CPUs des workers (round-robin), vide = non épinglés
+    int numa_node = -1;                 // Restreindre reactor/workers à ce nœud, -1 = aucun
+
+    // Steering des connexions vers le cœur qui traite leur file RX
+    bool incoming_cpu = false;          // SO_INCOMING_CPU = reactor_cpu sur le socket d'écoute
+    int reuseport_cbpf_group = 0;       // Taille du groupe SO_REUSEPORT (processus), 0 = désactivé
+
+    // Options TCP/socket
+    SocketTuning::Profile tuning_profile = SocketTuning::DEFAULT;
+    SocketOptions socket_options;
+
+    // Access log asynchrone (désactivé si le chemin est vide)
+    std::string access_log_path;
+    AccessLog::Format access_log_format = AccessLog::COMMON;
+    uint64_t access_log_max_bytes = 100 * 1024 * 1024;  // Taille avant rotation
+    int access_log_files = 5;                            // Fichiers conservés, 0 = pas de rotation
+
+    // Traçage par phase d'une fraction des requêtes (export sur SIGUSR1)
+    double trace_sample_rate = 0.0;     // 0 = désactivé, 1 = toutes les requêtes
+    std::string trace_file = "trace.json";
+
+    // Routes de mesure (/bytes/N, /stream/N), désactivées en production
+    bool bench_routes = false;
+
+    // Envois MSG_ZEROCOPY des corps d'au moins ce nombre d'octets (0 = désactivé)
+    size_t zerocopy_threshold = 0;
+
+    // Fichiers statiques (désactivés si la racine est vide)
+    std::string static_root;
+    size_t file_cache_bytes = 64 * 1024 * 1024;         // Budget du cache de fichiers
+
+    // HTTPS (désactivé si tls_port <= 0)
+    int tls_port = 0;
+    std::string tls_cert;               // Chaîne de certificats PEM
+    std::string tls_key;                // Clé privée PEM
+    bool ktls = false;                  // Déléguer le chiffrement au noyau si supporté
+
+    // WebSocket (route /ws)
+    int ws_ping_interval = 30;          // Inactivité avant un ping (secondes)
+    int ws_pong_timeout = 10;           // Délai de réponse au ping avant fermeture (secondes)
+    bool ws_relay = false;              // Rediffuser les messages des clients à tous les abonnés
+};
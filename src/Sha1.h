@@ -0,0 +1,16 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * SHA-1 (RFC 3174), utilisé uniquement pour la poignée de main WebSocket
+ */
+class Sha1 {
+public:
+    using Digest = std::array<uint8_t, 20>;
+
+    static Digest hash(const std::string& data);
+};
@@ -0,0 +1,125 @@
+#include "SocketTuning.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/filter.h>
+#include <iostream>
+
+namespace {
+
+bool set_int_option(int fd, int level, int name, int value, const char* label) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) < 0) {
+        std::cerr << "Avertissement: setsockopt " << label << " échoué" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool SocketTuning::parse_profile(const std::string& name, Profile& profile) {
+    if (name == "default") {
+        profile = DEFAULT;
+    } else if (name == "latency") {
+        profile = LATENCY;
+    } else if (name == "throughput") {
+        profile = THROUGHPUT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string SocketTuning::profile_name(Profile profile) {
+    switch (profile) {
+        case DEFAULT: return "default";
+        case LATENCY: return "latency";
+        case THROUGHPUT: return "throughput";
+        default: return "unknown";
+    }
+}
+
+SocketOptions SocketTuning::options_for(Profile profile) {
+    SocketOptions options;
+
+    switch (profile) {
+        case LATENCY:
+            options.tcp_nodelay = true;
+            options.fastopen_queue = 256;
+            options.busy_poll_us = 50;
+            break;
+        case THROUGHPUT:
+            options.tcp_nodelay = true;
+            options.defer_accept = 1;
+            options.fastopen_queue = 4096;
+            options.sndbuf = 1 << 20;
+            break;
+        case DEFAULT:
+        default:
+            break;
+    }
+
+    return options;
+}
+
+bool SocketTuning::apply_listener(int fd, const SocketOptions& options) {
+    // SO_REUSEADDR et SO_REUSEPORT sont deux options distinctes
+    if (!set_int_option(fd, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR") ||
+        !set_int_option(fd, SOL_SOCKET, SO_REUSEPORT, 1, "SO_REUSEPORT")) {
+        return false;
+    }
+
+    // Les options suivantes sont facultatives: un échec n'empêche pas le démarrage
+    if (options.defer_accept > 0) {
+        set_int_option(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, options.defer_accept, "TCP_DEFER_ACCEPT");
+    }
+    if (options.fastopen_queue > 0) {
+        set_int_option(fd, IPPROTO_TCP, TCP_FASTOPEN, options.fastopen_queue, "TCP_FASTOPEN");
+    }
+    if (options.busy_poll_us > 0) {
+        // Hérité par les sockets acceptés; au-delà de net.core.busy_read, requiert CAP_NET_ADMIN
+        set_int_option(fd, SOL_SOCKET, SO_BUSY_POLL, options.busy_poll_us, "SO_BUSY_POLL");
+    }
+    // Les tailles de buffers doivent être fixées avant listen() pour le window scaling
+    if (options.rcvbuf > 0) {
+        set_int_option(fd, SOL_SOCKET, SO_RCVBUF, options.rcvbuf, "SO_RCVBUF");
+    }
+    if (options.sndbuf > 0) {
+        set_int_option(fd, SOL_SOCKET, SO_SNDBUF, options.sndbuf, "SO_SNDBUF");
+    }
+
+    return true;
+}
+
+void SocketTuning::apply_client(int fd, const SocketOptions& options) {
+    if (options.tcp_nodelay) {
+        int opt = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+    }
+}
+
+bool SocketTuning::set_incoming_cpu(int fd, int cpu) {
+    return set_int_option(fd, SOL_SOCKET, SO_INCOMING_CPU, cpu, "SO_INCOMING_CPU");
+}
+
+bool SocketTuning::attach_reuseport_cbpf(int fd, int group_size) {
+    if (group_size <= 0) {
+        return false;
+    }
+
+    // A = CPU courant (celui qui traite la file RX); A %= group_size; return A
+    struct sock_filter code[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<__u32>(SKF_AD_OFF + SKF_AD_CPU) },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<__u32>(group_size) },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        std::cerr << "Avertissement: SO_ATTACH_REUSEPORT_CBPF échoué" << std::endl;
+        return false;
+    }
+    return true;
+}
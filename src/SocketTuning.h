@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Profils de réglage des options TCP/socket
+ * Appliqués au socket d'écoute (hérités par les connexions acceptées)
+ * et à chaque connexion cliente
+ */
+struct SocketOptions {
+    bool tcp_nodelay = false;   // Désactiver Nagle sur les connexions clientes
+    int defer_accept = 0;       // TCP_DEFER_ACCEPT (secondes), 0 = désactivé
+    int fastopen_queue = 0;     // TCP_FASTOPEN (longueur de queue), 0 = désactivé
+    int busy_poll_us = 0;       // SO_BUSY_POLL (microsecondes), 0 = désactivé
+    int rcvbuf = 0;             // SO_RCVBUF (octets), 0 = auto-tuning du noyau
+    int sndbuf = 0;             // SO_SNDBUF (octets), 0 = auto-tuning du noyau
+};
+
+class SocketTuning {
+public:
+    enum Profile {
+        DEFAULT,     // Comportement du noyau, aucune option supplémentaire
+        LATENCY,     // Petites requêtes interactives: Nagle désactivé, busy polling
+        THROUGHPUT   // Gros volumes: accept différé, TFO, buffers élargis
+    };
+
+    // Convertir un nom de profil ("default", "latency", "throughput")
+    static bool parse_profile(const std::string& name, Profile& profile);
+    static std::string profile_name(Profile profile);
+
+    // Options associées à un profil
+    static SocketOptions options_for(Profile profile);
+
+    // Options du socket d'écoute (avant bind/listen)
+    static bool apply_listener(int fd, const SocketOptions& options);
+
+    // Options d'une connexion acceptée
+    static void apply_client(int fd, const SocketOptions& options);
+
+    // Steering: préférer ce socket pour les connexions reçues sur le CPU donné
+    static bool set_incoming_cpu(int fd, int cpu);
+
+    // Steering: programme CBPF choisissant le socket du groupe SO_REUSEPORT
+    // d'index (CPU de réception % group_size)
+    static bool attach_reuseport_cbpf(int fd, int group_size);
+};
@@ -1,10 +1,17 @@
 #include "ThreadPool.h"
+#include "CpuAffinity.h"
 #include <algorithm>
+#include <iostream>
 
-ThreadPool::ThreadPool(size_t num_threads) {
+ThreadPool::ThreadPool(size_t num_threads)
+    : ThreadPool(num_threads, std::vector<int>()) {
+}
+
+ThreadPool::ThreadPool(size_t num_threads, const std::vector<int>& cpus) {
     threads_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
-        threads_.emplace_back(&ThreadPool::worker_thread, this);
+        int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        threads_.emplace_back(&ThreadPool::worker_thread, this, cpu);
     }
 }
 
@@ -12,7 +19,11 @@ ThreadPool::~ThreadPool() {
     shutdown();
 }
 
-void ThreadPool::worker_thread() {
+void ThreadPool::worker_thread(int cpu) {
+    if (cpu >= 0 && !CpuAffinity::pin_current_thread(cpu)) {
+        std::cerr << "Avertissement: impossible d'épingler un worker sur le CPU " << cpu << std::endl;
+    }
+
     while (true) {
         std::function<void()> task;
         {
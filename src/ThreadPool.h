@@ -16,6 +16,9 @@
 class ThreadPool {
 public:
     explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency());
+
+    // Worker i épinglé sur cpus[i % cpus.size()] (aucun épinglage si vide)
+    ThreadPool(size_t num_threads, const std::vector<int>& cpus);
     ~ThreadPool();
 
     // Non-copyable, non-movable
@@ -41,7 +44,7 @@ private:
     std::condition_variable condition_;
     std::atomic<bool> stop_{false};
 
-    void worker_thread();
+    void worker_thread(int cpu);
 };
 
 template<typename F, typename... Args>
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Indice par thread dans les buffers d'une instance (rings de l'access log,
+ * traces): attribué au premier appel d'un thread, puis lu dans un cache
+ * thread_local sans aucune synchronisation. Owner sépare les caches des
+ * différents utilisateurs, qui alternent sur les mêmes workers.
+ */
+template<typename Owner>
+class ThreadSlot {
+public:
+    ThreadSlot() : instance_id_(next_instance_id()) {}
+
+    // Non-copyable
+    ThreadSlot(const ThreadSlot&) = delete;
+    ThreadSlot& operator=(const ThreadSlot&) = delete;
+
+    // 0 pour le premier thread appelant, 1 pour le suivant...
+    size_t index() {
+        struct Cache {
+            uint64_t instance = 0;
+            size_t index = 0;
+        };
+        thread_local Cache cache;
+        if (cache.instance != instance_id_) {
+            cache.instance = instance_id_;
+            cache.index = next_index_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return cache.index;
+    }
+
+private:
+    // Une instance recréée (redémarrage du serveur) ne reprend pas les indices de la précédente
+    static uint64_t next_instance_id() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1);
+    }
+
+    uint64_t instance_id_;
+    std::atomic<size_t> next_index_{0};
+};
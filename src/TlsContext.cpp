@@ -0,0 +1,109 @@
+#include "TlsContext.h"
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <iostream>
+
+namespace {
+
+// Protocoles proposés par le serveur, par ordre de préférence (format ALPN)
+const unsigned char ALPN_PROTOCOLS[] = "\x02h2\x08http/1.1";
+
+int select_alpn(SSL*, const unsigned char** out, unsigned char* outlen,
+                const unsigned char* in, unsigned int inlen, void*) {
+    unsigned char* selected = nullptr;
+    if (SSL_select_next_proto(&selected, outlen, ALPN_PROTOCOLS, sizeof(ALPN_PROTOCOLS) - 1,
+                              in, inlen) != OPENSSL_NPN_NEGOTIATED) {
+        return SSL_TLSEXT_ERR_NOACK; // Pas de protocole commun: HTTP/1.1 sans ALPN
+    }
+    *out = selected;
+    return SSL_TLSEXT_ERR_OK;
+}
+
+} // namespace
+
+TlsContext::TlsContext() = default;
+
+TlsContext::~TlsContext() {
+    if (ctx_) {
+        SSL_CTX_free(ctx_);
+    }
+}
+
+bool TlsContext::init(const std::string& cert_file, const std::string& key_file, bool enable_ktls) {
+    ctx_ = SSL_CTX_new(TLS_server_method());
+    if (!ctx_) {
+        log_errors("SSL_CTX_new");
+        return false;
+    }
+
+    SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+
+    // Écritures non bloquantes: le buffer peut changer d'adresse entre deux tentatives
+    SSL_CTX_set_mode(ctx_, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER |
+                           SSL_MODE_RELEASE_BUFFERS);
+
+    if (enable_ktls) {
+#ifdef SSL_OP_ENABLE_KTLS
+        SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+#else
+        std::cerr << "kTLS indisponible avant OpenSSL 3.0: chiffrement en espace utilisateur" << std::endl;
+#endif
+    }
+
+    if (SSL_CTX_use_certificate_chain_file(ctx_, cert_file.c_str()) != 1 ||
+        SSL_CTX_use_PrivateKey_file(ctx_, key_file.c_str(), SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(ctx_) != 1) {
+        log_errors("chargement du certificat");
+        return false;
+    }
+
+    // Reprise de session: cache côté serveur (session IDs) et tickets (sans état)
+    static const unsigned char SESSION_ID_CONTEXT[] = "hps";
+    SSL_CTX_set_session_id_context(ctx_, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_sess_set_cache_size(ctx_, 20480);
+    SSL_CTX_set_timeout(ctx_, 300);
+    SSL_CTX_clear_options(ctx_, SSL_OP_NO_TICKET);
+    SSL_CTX_set_num_tickets(ctx_, 1);
+
+    SSL_CTX_set_alpn_select_cb(ctx_, select_alpn, nullptr);
+    return true;
+}
+
+SSL* TlsContext::create_ssl(int fd) const {
+    SSL* ssl = SSL_new(ctx_);
+    if (!ssl) {
+        return nullptr;
+    }
+    if (SSL_set_fd(ssl, fd) != 1) {
+        SSL_free(ssl);
+        return nullptr;
+    }
+    SSL_set_accept_state(ssl);
+    return ssl;
+}
+
+std::string TlsContext::alpn_protocol(SSL* ssl) {
+    const unsigned char* data = nullptr;
+    unsigned int len = 0;
+    SSL_get0_alpn_selected(ssl, &data, &len);
+    return data ? std::string(reinterpret_cast<const char*>(data), len) : std::string();
+}
+
+bool TlsContext::ktls_send_enabled(SSL* ssl) {
+#ifdef SSL_OP_ENABLE_KTLS
+    return BIO_get_ktls_send(SSL_get_wbio(ssl)) > 0;
+#else
+    (void)ssl;
+    return false;
+#endif
+}
+
+void TlsContext::log_errors(const char* context) {
+    unsigned long error;
+    while ((error = ERR_get_error()) != 0) {
+        char buffer[256];
+        ERR_error_string_n(error, buffer, sizeof(buffer));
+        std::cerr << "Erreur TLS (" << context << "): " << buffer << std::endl;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+typedef struct ssl_st SSL;
+typedef struct ssl_ctx_st SSL_CTX;
+
+/**
+ * Contexte TLS serveur (OpenSSL)
+ * Certificat, cache de sessions et tickets pour la reprise, ALPN (h2,
+ * http/1.1) et kTLS optionnel: une fois la poignée de main terminée, le
+ * chiffrement en émission est délégué au noyau quand il le supporte.
+ */
+class TlsContext {
+public:
+    TlsContext();
+    ~TlsContext();
+
+    // Non-copyable, non-movable
+    TlsContext(const TlsContext&) = delete;
+    TlsContext& operator=(const TlsContext&) = delete;
+    TlsContext(TlsContext&&) = delete;
+    TlsContext& operator=(TlsContext&&) = delete;
+
+    // Charger le certificat et la clé (PEM)
+    bool init(const std::string& cert_file, const std::string& key_file, bool enable_ktls);
+
+    // Créer l'objet SSL d'une connexion acceptée (côté serveur)
+    SSL* create_ssl(int fd) const;
+
+    // Protocole négocié par ALPN ("h2", "http/1.1" ou vide)
+    static std::string alpn_protocol(SSL* ssl);
+
+    // kTLS actif en émission: send/sendfile directs sur le socket
+    static bool ktls_send_enabled(SSL* ssl);
+
+    static void log_errors(const char* context);
+
+private:
+    SSL_CTX* ctx_ = nullptr;
+};
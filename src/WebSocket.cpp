@@ -0,0 +1,154 @@
+#include "WebSocket.h"
+#include "Base64.h"
+#include "Sha1.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char HANDSHAKE_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+std::string to_lower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+}
+
+} // namespace
+
+bool WebSocket::is_upgrade_request(const HttpRequest& request) {
+    return request.method == "GET" &&
+           to_lower(request.get_header("upgrade")) == "websocket" &&
+           to_lower(request.get_header("connection")).find("upgrade") != std::string::npos &&
+           request.get_header("sec-websocket-version") == "13" &&
+           !request.get_header("sec-websocket-key").empty();
+}
+
+std::string WebSocket::accept_key(const std::string& client_key) {
+    Sha1::Digest digest = Sha1::hash(client_key + HANDSHAKE_GUID);
+    return Base64::encode(digest.data(), digest.size());
+}
+
+WebSocket::ParseResult WebSocket::parse_frame(const char* data, size_t len,
+                                              WebSocketFrame& frame, size_t& consumed) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+    if (len < 2) {
+        return FRAME_INCOMPLETE;
+    }
+
+    frame.fin = (p[0] & 0x80) != 0;
+    frame.opcode = p[0] & 0x0f;
+    bool masked = (p[1] & 0x80) != 0;
+    uint64_t payload_len = p[1] & 0x7f;
+
+    // Aucune extension négociée: RSV1-3 doivent être nuls; le client masque toujours
+    if ((p[0] & 0x70) != 0 || !masked) {
+        return FRAME_ERROR;
+    }
+
+    size_t header_len = 2;
+    if (payload_len == 126) {
+        if (len < 4) {
+            return FRAME_INCOMPLETE;
+        }
+        payload_len = (static_cast<uint64_t>(p[2]) << 8) | p[3];
+        header_len = 4;
+    } else if (payload_len == 127) {
+        if (len < 10) {
+            return FRAME_INCOMPLETE;
+        }
+        payload_len = 0;
+        for (int i = 0; i < 8; ++i) {
+            payload_len = (payload_len << 8) | p[2 + i];
+        }
+        header_len = 10;
+    }
+
+    // Trames de contrôle: non fragmentées, 125 octets au plus
+    if ((frame.opcode & 0x08) && (!frame.fin || payload_len > 125)) {
+        return FRAME_ERROR;
+    }
+    if (payload_len > MAX_PAYLOAD) {
+        return FRAME_TOO_LARGE;
+    }
+
+    size_t total = header_len + 4 + static_cast<size_t>(payload_len);
+    if (len < total) {
+        return FRAME_INCOMPLETE;
+    }
+
+    uint8_t mask[4];
+    std::memcpy(mask, p + header_len, 4);
+    frame.payload.assign(data + header_len + 4, static_cast<size_t>(payload_len));
+    unmask(&frame.payload[0], frame.payload.size(), mask);
+
+    consumed = total;
+    return FRAME_OK;
+}
+
+std::string WebSocket::encode_frame(uint8_t opcode, const std::string& payload, bool fin) {
+    std::string frame;
+    frame.reserve(payload.size() + 10);
+    frame += static_cast<char>((fin ? 0x80 : 0x00) | (opcode & 0x0f));
+
+    uint64_t len = payload.size();
+    if (len < 126) {
+        frame += static_cast<char>(len);
+    } else if (len <= 0xffff) {
+        frame += static_cast<char>(126);
+        frame += static_cast<char>(len >> 8);
+        frame += static_cast<char>(len);
+    } else {
+        frame += static_cast<char>(127);
+        for (int i = 7; i >= 0; --i) {
+            frame += static_cast<char>(len >> (i * 8));
+        }
+    }
+
+    frame += payload;
+    return frame;
+}
+
+std::string WebSocket::encode_close(uint16_t code) {
+    std::string payload;
+    payload += static_cast<char>(code >> 8);
+    payload += static_cast<char>(code);
+    return encode_frame(CLOSE, payload);
+}
+
+void WebSocket::unmask(char* data, size_t len, const uint8_t mask[4]) {
+    size_t i = 0;
+    uint32_t mask32;
+    std::memcpy(&mask32, mask, 4);
+
+#if defined(__AVX2__)
+    const __m256i mask256 = _mm256_set1_epi32(static_cast<int>(mask32));
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), _mm256_xor_si256(chunk, mask256));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i mask128 = _mm_set1_epi32(static_cast<int>(mask32));
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(chunk, mask128));
+    }
+#endif
+
+    // Mots de 64 bits, puis octets restants (i reste multiple de 4: la phase du masque est conservée)
+    uint64_t mask64 = (static_cast<uint64_t>(mask32) << 32) | mask32;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        word ^= mask64;
+        std::memcpy(data + i, &word, 8);
+    }
+    for (; i < len; ++i) {
+        data[i] ^= mask[i & 3];
+    }
+}
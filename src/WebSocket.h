@@ -0,0 +1,60 @@
+#pragma once
+
+#include "HttpRequest.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Trame WebSocket décodée (payload déjà démasqué)
+ */
+struct WebSocketFrame {
+    bool fin = true;
+    uint8_t opcode = 0;
+    std::string payload;
+};
+
+/**
+ * Protocole WebSocket (RFC 6455): poignée de main et codec de trames
+ */
+class WebSocket {
+public:
+    enum Opcode : uint8_t {
+        CONTINUATION = 0x0,
+        TEXT = 0x1,
+        BINARY = 0x2,
+        CLOSE = 0x8,
+        PING = 0x9,
+        PONG = 0xA
+    };
+
+    enum ParseResult {
+        FRAME_OK,
+        FRAME_INCOMPLETE,
+        FRAME_ERROR,
+        FRAME_TOO_LARGE
+    };
+
+    // Codes de fermeture
+    static constexpr uint16_t CLOSE_NORMAL = 1000;
+    static constexpr uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+    static constexpr uint16_t CLOSE_TOO_LARGE = 1009;
+
+    static constexpr size_t MAX_PAYLOAD = 1 << 20;
+
+    // La requête demande-t-elle un passage en WebSocket ?
+    static bool is_upgrade_request(const HttpRequest& request);
+
+    // Sec-WebSocket-Accept = base64(SHA-1(clé + GUID))
+    static std::string accept_key(const std::string& client_key);
+
+    // Décoder une trame client (masquée); consumed = octets utilisés si FRAME_OK
+    static ParseResult parse_frame(const char* data, size_t len, WebSocketFrame& frame, size_t& consumed);
+
+    // Encoder une trame serveur (jamais masquée)
+    static std::string encode_frame(uint8_t opcode, const std::string& payload, bool fin = true);
+    static std::string encode_close(uint16_t code);
+
+    // XOR du masque sur le payload, vectorisé (AVX2/SSE2) quand disponible
+    static void unmask(char* data, size_t len, const uint8_t mask[4]);
+};
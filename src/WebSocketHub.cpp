@@ -0,0 +1,207 @@
+#include "WebSocketHub.h"
+#include "WebSocket.h"
+#include "Connection.h"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+
+// ---------------------------------------------------------------------------
+// WebSocketSession
+
+WebSocketSession::WebSocketSession(Connection* conn) : conn_(conn), fd_(conn->fd) {
+    touch();
+}
+
+ssize_t WebSocketSession::read(void* data, size_t len) {
+    return conn_->read(data, len);
+}
+
+bool WebSocketSession::send(const Buffer& frame) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (closed_) {
+        return false;
+    }
+
+    // File vide: tenter l'envoi direct sans conserver de référence
+    size_t offset = 0;
+    if (queue_.empty()) {
+        while (offset < frame->size()) {
+            ssize_t n = conn_->write(frame->data() + offset, frame->size() - offset);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    return false; // Erreur: le lecteur verra la fermeture
+                }
+                break;
+            }
+            offset += n;
+        }
+        if (offset == frame->size()) {
+            return true;
+        }
+    }
+
+    // Le reste part sur EPOLLOUT
+    queue_.push_back({frame, offset});
+    queued_bytes_ += frame->size() - offset;
+    if (queued_bytes_ > MAX_QUEUED_BYTES) {
+        ::shutdown(fd_, SHUT_RDWR);
+        return false;
+    }
+    return true;
+}
+
+void WebSocketSession::flush() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!closed_) {
+        flush_locked();
+    }
+}
+
+void WebSocketSession::flush_locked() {
+    constexpr int MAX_IOV = 64;
+
+    while (!queue_.empty()) {
+        struct iovec iov[MAX_IOV];
+        int count = 0;
+        for (auto it = queue_.begin(); it != queue_.end() && count < MAX_IOV; ++it, ++count) {
+            iov[count].iov_base = const_cast<char*>(it->buffer->data() + it->offset);
+            iov[count].iov_len = it->buffer->size() - it->offset;
+        }
+
+        ssize_t n = conn_->writev(iov, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // EAGAIN: attendre le prochain EPOLLOUT
+        }
+
+        queued_bytes_ -= n;
+        size_t written = static_cast<size_t>(n);
+        while (written > 0) {
+            Pending& front = queue_.front();
+            size_t remaining = front.buffer->size() - front.offset;
+            if (written >= remaining) {
+                written -= remaining;
+                queue_.pop_front();
+            } else {
+                front.offset += written;
+                written = 0;
+            }
+        }
+    }
+}
+
+void WebSocketSession::close() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    closed_.store(true, std::memory_order_release);
+    queue_.clear();
+    queued_bytes_ = 0;
+}
+
+void WebSocketSession::abort() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!closed_) {
+        ::shutdown(fd_, SHUT_RDWR);
+    }
+}
+
+bool WebSocketSession::begin_read() {
+    return read_requests_.fetch_add(1) == 0;
+}
+
+bool WebSocketSession::end_read(int& handled) {
+    int remaining = read_requests_.fetch_sub(handled) - handled;
+    if (remaining == 0) {
+        return true;
+    }
+    handled = remaining;
+    return false;
+}
+
+void WebSocketSession::touch() {
+    last_activity_ms.store(WebSocketHub::now_ms(), std::memory_order_relaxed);
+    awaiting_pong.store(false, std::memory_order_relaxed);
+}
+
+// ---------------------------------------------------------------------------
+// WebSocketHub
+
+WebSocketHub::WebSocketHub(std::chrono::seconds ping_interval, std::chrono::seconds pong_timeout)
+    : ping_interval_ms_(std::chrono::duration_cast<std::chrono::milliseconds>(ping_interval).count()),
+      pong_timeout_ms_(std::chrono::duration_cast<std::chrono::milliseconds>(pong_timeout).count()) {
+}
+
+int64_t WebSocketHub::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void WebSocketHub::subscribe(const std::shared_ptr<WebSocketSession>& session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    session->hub_index = sessions_.size();
+    sessions_.push_back(session);
+}
+
+void WebSocketHub::unsubscribe(const std::shared_ptr<WebSocketSession>& session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t index = session->hub_index;
+    if (index >= sessions_.size() || sessions_[index] != session) {
+        return;
+    }
+
+    // Swap-and-pop: O(1)
+    sessions_[index] = std::move(sessions_.back());
+    sessions_[index]->hub_index = index;
+    sessions_.pop_back();
+}
+
+size_t WebSocketHub::broadcast(const std::string& message, bool binary) {
+    auto frame = std::make_shared<const std::string>(
+        WebSocket::encode_frame(binary ? WebSocket::BINARY : WebSocket::TEXT, message));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t delivered = 0;
+    for (const auto& session : sessions_) {
+        if (session->send(frame)) {
+            ++delivered;
+        }
+    }
+    return delivered;
+}
+
+void WebSocketHub::check_keepalive() {
+    static const WebSocketSession::Buffer ping =
+        std::make_shared<const std::string>(WebSocket::encode_frame(WebSocket::PING, ""));
+
+    int64_t now = now_ms();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& session : sessions_) {
+        if (session->awaiting_pong.load(std::memory_order_relaxed)) {
+            if (now - session->ping_sent_ms > pong_timeout_ms_) {
+                session->abort(); // Le lecteur verra EOF et fermera la connexion
+            }
+        } else if (now - session->last_activity_ms.load(std::memory_order_relaxed) > ping_interval_ms_) {
+            session->ping_sent_ms = now;
+            session->awaiting_pong.store(true, std::memory_order_relaxed);
+            session->send(ping);
+        }
+    }
+}
+
+void WebSocketHub::close_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& session : sessions_) {
+        session->close();
+    }
+    sessions_.clear();
+}
+
+size_t WebSocketHub::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Connection;
+
+/**
+ * État WebSocket d'une connexion
+ * Les trames sortantes sont des buffers partagés: une diffusion encode la
+ * trame une seule fois et chaque abonné ne garde qu'une référence dessus.
+ */
+class WebSocketSession {
+public:
+    using Buffer = std::shared_ptr<const std::string>;
+
+    // La connexion reste valide jusqu'à close(), appelé avant sa destruction
+    explicit WebSocketSession(Connection* conn);
+
+    // Non-copyable, non-movable
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+
+    // Envoyer (ou mettre en file) une trame encodée; false si la session est fermée
+    bool send(const Buffer& frame);
+
+    // Écrire la file d'attente (socket de nouveau inscriptible)
+    void flush();
+
+    // Plus aucune écriture après cet appel: le fd peut être fermé
+    void close();
+
+    // Forcer la fermeture par le thread de lecture (EOF sur le socket)
+    void abort();
+
+    // Lecture par le worker actif (clair ou TLS)
+    ssize_t read(void* data, size_t len);
+
+    int fd() const { return fd_; }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // Lecture: un seul worker à la fois draine le socket. begin_read() retourne
+    // false si un autre worker lit déjà (il refera un tour); end_read() retourne
+    // false s'il faut relire, handled contenant alors les demandes restantes
+    bool begin_read();
+    bool end_read(int& handled);
+
+    // Assemblage des trames reçues (manipulé uniquement par le lecteur actif)
+    std::string input;
+    std::string message;
+    uint8_t message_opcode = 0;
+    bool close_sent = false;        // CLOSE déjà envoyée: jamais une seconde
+
+    // Keepalive
+    void touch();
+    std::atomic<int64_t> last_activity_ms{0};
+    std::atomic<bool> awaiting_pong{false};
+    int64_t ping_sent_ms = 0;
+
+    // Index dans le hub (swap-and-pop)
+    size_t hub_index = 0;
+
+private:
+    struct Pending {
+        Buffer buffer;
+        size_t offset;
+    };
+
+    Connection* conn_;
+    int fd_;
+    std::atomic<int> read_requests_{0};
+    std::mutex write_mutex_;
+    std::deque<Pending> queue_;
+    size_t queued_bytes_ = 0;
+    std::atomic<bool> closed_{false};
+
+    // Au-delà, l'abonné est trop lent: la connexion est coupée
+    static constexpr size_t MAX_QUEUED_BYTES = 4 * 1024 * 1024;
+
+    void flush_locked();
+};
+
+/**
+ * Abonnés WebSocket et diffusion (fan-out)
+ */
+class WebSocketHub {
+public:
+    WebSocketHub(std::chrono::seconds ping_interval = std::chrono::seconds(30),
+                 std::chrono::seconds pong_timeout = std::chrono::seconds(10));
+
+    void subscribe(const std::shared_ptr<WebSocketSession>& session);
+    void unsubscribe(const std::shared_ptr<WebSocketSession>& session);
+
+    // Encoder une fois, écrire le même buffer vers tous les abonnés
+    size_t broadcast(const std::string& message, bool binary = false);
+
+    // Envoyer les pings dus et couper les connexions sans pong (appelé par le reactor)
+    void check_keepalive();
+
+    // Fermer toutes les sessions (arrêt du serveur)
+    void close_all();
+
+    size_t size();
+
+    static int64_t now_ms();
+
+private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<WebSocketSession>> sessions_;
+    int64_t ping_interval_ms_;
+    int64_t pong_timeout_ms_;
+};
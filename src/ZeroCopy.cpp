@@ -0,0 +1,93 @@
+#include "ZeroCopy.h"
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <cerrno>
+#include <cstring>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+bool ZeroCopySender::enable(int fd) {
+    int one = 1;
+    return setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0;
+}
+
+ZeroCopySender::Stats& ZeroCopySender::stats() {
+    static Stats instance;
+    return instance;
+}
+
+ssize_t ZeroCopySender::send(int fd, const struct iovec* iov, int count, const std::vector<Buffer>& buffers) {
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = count;
+
+    ssize_t n = ::sendmsg(fd, &msg, MSG_ZEROCOPY | MSG_NOSIGNAL);
+    if (n < 0 && errno == ENOBUFS) {
+        // Trop de pages épinglées (optmem_max): récupérer les notifications, puis copier
+        drain(fd);
+        stats().fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+    }
+    if (n < 0) {
+        return n;
+    }
+
+    pending_.push_back({next_id_++, buffers});
+    stats().sends.fetch_add(1, std::memory_order_relaxed);
+    stats().bytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    return n;
+}
+
+size_t ZeroCopySender::drain(int fd) {
+    size_t completed = 0;
+
+    while (true) {
+        char control[128];
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (::recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            break; // EAGAIN: plus de notification pour l'instant
+        }
+
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            bool recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                           (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!recverr) {
+                continue;
+            }
+
+            struct sock_extended_err err;
+            std::memcpy(&err, CMSG_DATA(cm), sizeof(err));
+            if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0) {
+                continue;
+            }
+
+            // Plage [ee_info, ee_data] d'envois terminés (compteur 32 bits modulaire)
+            uint32_t lo = err.ee_info;
+            uint32_t span = err.ee_data - lo;
+            size_t before = pending_.size();
+            while (!pending_.empty() && pending_.front().id - lo <= span) {
+                pending_.pop_front();
+            }
+            size_t released = before - pending_.size();
+            completed += released;
+            stats().completions.fetch_add(released, std::memory_order_relaxed);
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                stats().copied.fetch_add(released, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    return completed;
+}
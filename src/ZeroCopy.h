@@ -0,0 +1,59 @@
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Envois MSG_ZEROCOPY d'une connexion (Linux 4.14+)
+ * Le noyau transmet directement les pages des buffers au lieu de les copier
+ * dans le tampon du socket: chaque buffer reste référencé jusqu'à la
+ * notification de fin lue dans la file d'erreurs du socket (MSG_ERRQUEUE).
+ */
+class ZeroCopySender {
+public:
+    using Buffer = std::shared_ptr<const std::string>;
+
+    // En dessous, épingler les pages et lire la notification coûte plus que la copie
+    static constexpr size_t MIN_THRESHOLD = 1024 * 1024;
+
+    // Compteurs globaux (tous les sockets)
+    struct Stats {
+        std::atomic<uint64_t> sends{0};         // Appels sendmsg(MSG_ZEROCOPY) réussis
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> completions{0};   // Envois confirmés par le noyau
+        std::atomic<uint64_t> copied{0};        // ...dont recopiés malgré tout (loopback, NIC sans SG)
+        std::atomic<uint64_t> fallbacks{0};     // ENOBUFS: envoi classique
+    };
+
+    // Activer SO_ZEROCOPY sur un socket
+    static bool enable(int fd);
+
+    // sendmsg(MSG_ZEROCOPY); les buffers sont conservés jusqu'à la notification.
+    // Sémantique de sendmsg: -1 et errno = EAGAIN si le socket est plein
+    ssize_t send(int fd, const struct iovec* iov, int count, const std::vector<Buffer>& buffers);
+
+    // Lire les notifications disponibles et libérer les buffers concernés;
+    // retourne le nombre d'envois terminés
+    size_t drain(int fd);
+
+    // Aucun envoi en attente de notification
+    bool idle() const { return pending_.empty(); }
+
+    static Stats& stats();
+
+private:
+    struct Pending {
+        uint32_t id;
+        std::vector<Buffer> buffers;
+    };
+
+    uint32_t next_id_ = 0;              // Le noyau numérote chaque envoi réussi à partir de 0
+    std::deque<Pending> pending_;
+};
@@ -1,13 +1,24 @@
 #include "HttpServer.h"
+#include "CpuAffinity.h"
+#include "ZeroCopy.h"
 #include <iostream>
 #include <csignal>
 #include <cstdlib>
 #include <thread>
 #include <chrono>
+#include <string>
+#include <vector>
 
 static HttpServer* g_server = nullptr;
 
 void signal_handler(int signal) {
+    if (signal == SIGUSR1) {
+        // Export des traces: simple drapeau, traité par la boucle epoll
+        if (g_server) {
+            g_server->request_trace_export();
+        }
+        return;
+    }
     if (signal == SIGINT || signal == SIGTERM) {
         std::cout << "\nSignal d'arrêt reçu..." << std::endl;
         if (g_server) {
@@ -17,34 +28,193 @@ void signal_handler(int signal) {
     }
 }
 
+// Lire une option de la forme --name=value
+static bool match_option(const std::string& arg, const std::string& name, std::string& value) {
+    const std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+static void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [port] [thread_pool_size] [options]\n"
+              << "  --max-connections=N     Connexions simultanées (défaut: 10000)\n"
+              << "  --profile=default|latency|throughput\n"
+              << "  --reactor-cpu=N         Épingler le thread epoll sur le CPU N\n"
+              << "  --worker-cpus=LISTE     Épingler les workers (ex: 0-3,8)\n"
+              << "  --numa-node=N           Restreindre les threads au nœud NUMA N\n"
+              << "  --incoming-cpu          SO_INCOMING_CPU = reactor-cpu\n"
+              << "  --reuseport-cbpf=N      Steering CBPF sur un groupe de N processus\n"
+              << "  --tcp-nodelay=0|1 --defer-accept=S --fastopen=QLEN\n"
+              << "  --busy-poll=USEC --rcvbuf=OCTETS --sndbuf=OCTETS\n"
+              << "  --access-log=FICHIER    Access log asynchrone\n"
+              << "  --access-log-format=common|json\n"
+              << "  --access-log-max-size=OCTETS --access-log-files=N\n"
+              << "  --ws-ping-interval=S --ws-pong-timeout=S\n"
+              << "  --ws-relay              Rediffuser les messages reçus sur /ws à tous les clients\n"
+              << "  --trace-sample=TAUX     Tracer une fraction des requêtes (0-1), export sur SIGUSR1\n"
+              << "  --trace-file=FICHIER    Fichier Chrome trace (défaut: trace.json)\n"
+              << "  --bench-routes          Activer les routes de mesure (/bytes/N, /stream/N)\n"
+              << "  --zerocopy-threshold=OCTETS MSG_ZEROCOPY pour les corps plus grands\n"
+              << "  --root=DIR              Servir les fichiers statiques de DIR\n"
+              << "  --file-cache-size=OCTETS Budget du cache de fichiers (défaut: 64 Mo)\n"
+              << "  --tls-port=N            Écoute HTTPS (requiert --tls-cert et --tls-key)\n"
+              << "  --tls-cert=PEM --tls-key=PEM\n"
+              << "  --ktls                  Chiffrement TLS délégué au noyau si supporté" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
+    ServerConfig config;
+    std::vector<std::string> positional;
+    std::vector<std::string> overrides;
+
+    // Séparer arguments positionnels et options
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") == 0) {
+            overrides.push_back(arg);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
     // Port par défaut : 8080
-    int port = 8080;
-    size_t thread_pool_size = std::thread::hardware_concurrency();
-    
-    // Parser les arguments
-    if (argc > 1) {
-        port = std::atoi(argv[1]);
-        if (port <= 0 || port > 65535) {
-            std::cerr << "Port invalide: " << argv[1] << std::endl;
+    if (positional.size() > 0) {
+        config.port = std::atoi(positional[0].c_str());
+        if (config.port <= 0 || config.port > 65535) {
+            std::cerr << "Port invalide: " << positional[0] << std::endl;
             return 1;
         }
     }
     
-    if (argc > 2) {
-        thread_pool_size = std::atoi(argv[2]);
-        if (thread_pool_size == 0) {
-            thread_pool_size = std::thread::hardware_concurrency();
+    if (positional.size() > 1) {
+        config.thread_pool_size = std::atoi(positional[1].c_str());
+        if (config.thread_pool_size == 0) {
+            config.thread_pool_size = std::thread::hardware_concurrency();
+        }
+    }
+
+    // Le profil est appliqué d'abord, les options individuelles le surchargent
+    for (const auto& arg : overrides) {
+        std::string value;
+        if (match_option(arg, "profile", value)) {
+            if (!SocketTuning::parse_profile(value, config.tuning_profile)) {
+                std::cerr << "Profil invalide: " << value << std::endl;
+                return 1;
+            }
+        }
+    }
+    config.socket_options = SocketTuning::options_for(config.tuning_profile);
+
+    for (const auto& arg : overrides) {
+        std::string value;
+        if (match_option(arg, "profile", value)) {
+            continue;
+        } else if (match_option(arg, "reactor-cpu", value)) {
+            config.reactor_cpu = std::atoi(value.c_str());
+        } else if (match_option(arg, "worker-cpus", value)) {
+            if (!CpuAffinity::parse_cpu_list(value, config.worker_cpus)) {
+                std::cerr << "Liste de CPUs invalide: " << value << std::endl;
+                return 1;
+            }
+        } else if (match_option(arg, "numa-node", value)) {
+            config.numa_node = std::atoi(value.c_str());
+            if (CpuAffinity::cpus_of_numa_node(config.numa_node).empty()) {
+                std::cerr << "Nœud NUMA inconnu: " << value << std::endl;
+                return 1;
+            }
+        } else if (arg == "--incoming-cpu") {
+            config.incoming_cpu = true;
+        } else if (match_option(arg, "reuseport-cbpf", value)) {
+            config.reuseport_cbpf_group = std::atoi(value.c_str());
+        } else if (match_option(arg, "tcp-nodelay", value)) {
+            config.socket_options.tcp_nodelay = std::atoi(value.c_str()) != 0;
+        } else if (match_option(arg, "defer-accept", value)) {
+            config.socket_options.defer_accept = std::atoi(value.c_str());
+        } else if (match_option(arg, "fastopen", value)) {
+            config.socket_options.fastopen_queue = std::atoi(value.c_str());
+        } else if (match_option(arg, "busy-poll", value)) {
+            config.socket_options.busy_poll_us = std::atoi(value.c_str());
+        } else if (match_option(arg, "rcvbuf", value)) {
+            config.socket_options.rcvbuf = std::atoi(value.c_str());
+        } else if (match_option(arg, "sndbuf", value)) {
+            config.socket_options.sndbuf = std::atoi(value.c_str());
+        } else if (match_option(arg, "max-connections", value)) {
+            config.max_connections = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (match_option(arg, "ws-ping-interval", value)) {
+            config.ws_ping_interval = std::atoi(value.c_str());
+        } else if (match_option(arg, "ws-pong-timeout", value)) {
+            config.ws_pong_timeout = std::atoi(value.c_str());
+        } else if (arg == "--ws-relay") {
+            config.ws_relay = true;
+        } else if (match_option(arg, "trace-sample", value)) {
+            config.trace_sample_rate = std::atof(value.c_str());
+            if (config.trace_sample_rate < 0.0 || config.trace_sample_rate > 1.0) {
+                std::cerr << "Taux d'échantillonnage invalide: " << value << std::endl;
+                return 1;
+            }
+        } else if (match_option(arg, "trace-file", value)) {
+            config.trace_file = value;
+        } else if (arg == "--bench-routes") {
+            config.bench_routes = true;
+        } else if (match_option(arg, "zerocopy-threshold", value)) {
+            config.zerocopy_threshold = std::strtoull(value.c_str(), nullptr, 10);
+            if (config.zerocopy_threshold > 0 && config.zerocopy_threshold < ZeroCopySender::MIN_THRESHOLD) {
+                std::cerr << "--zerocopy-threshold relevé à " << ZeroCopySender::MIN_THRESHOLD
+                          << " octets: en dessous, la copie coûte moins cher" << std::endl;
+                config.zerocopy_threshold = ZeroCopySender::MIN_THRESHOLD;
+            }
+        } else if (match_option(arg, "root", value)) {
+            config.static_root = value;
+        } else if (match_option(arg, "file-cache-size", value)) {
+            config.file_cache_bytes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (match_option(arg, "tls-port", value)) {
+            config.tls_port = std::atoi(value.c_str());
+        } else if (match_option(arg, "tls-cert", value)) {
+            config.tls_cert = value;
+        } else if (match_option(arg, "tls-key", value)) {
+            config.tls_key = value;
+        } else if (arg == "--ktls") {
+            config.ktls = true;
+        } else if (match_option(arg, "access-log", value)) {
+            config.access_log_path = value;
+        } else if (match_option(arg, "access-log-format", value)) {
+            if (!AccessLog::parse_format(value, config.access_log_format)) {
+                std::cerr << "Format d'access log invalide: " << value << std::endl;
+                return 1;
+            }
+        } else if (match_option(arg, "access-log-max-size", value)) {
+            config.access_log_max_bytes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (match_option(arg, "access-log-files", value)) {
+            config.access_log_files = std::atoi(value.c_str());
+        } else {
+            std::cerr << "Option inconnue: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
         }
     }
 
+    if (config.incoming_cpu && config.reactor_cpu < 0) {
+        std::cerr << "--incoming-cpu requiert --reactor-cpu" << std::endl;
+        return 1;
+    }
+
+    if (config.tls_port > 0 && (config.tls_cert.empty() || config.tls_key.empty())) {
+        std::cerr << "--tls-port requiert --tls-cert et --tls-key" << std::endl;
+        return 1;
+    }
+
     // Configurer les handlers de signal
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
+    signal(SIGUSR1, signal_handler);
     signal(SIGPIPE, SIG_IGN); // Ignorer SIGPIPE
 
     // Créer et démarrer le serveur
-    HttpServer server(port, thread_pool_size, 10000);
+    std::cout << "Profil réseau: " << SocketTuning::profile_name(config.tuning_profile) << std::endl;
+    HttpServer server(config);
     g_server = &server;
     
     server.start();
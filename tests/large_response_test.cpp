@@ -0,0 +1,209 @@
+/**
+ * Test d'intégration: réponses plus grandes que le buffer d'envoi du socket
+ * Lance le serveur en sous-processus, télécharge un corps généré (/bytes/N)
+ * et un gros fichier statique (--root) avec un client qui tarde à lire, puis
+ * vérifie le corps reçu et que le serveur est toujours en vie.
+ *
+ * Usage: large_response_test <binaire du serveur>
+ */
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+constexpr size_t GENERATED_BYTES = 16 * 1024 * 1024;
+constexpr size_t FILE_BYTES = 20 * 1024 * 1024;
+
+// Motif des routes /bytes/N, repris pour le fichier statique
+char pattern_at(size_t i) {
+    return static_cast<char>('a' + i % 26);
+}
+
+int free_port() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+bool write_file(const std::string& path, size_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    std::string block(64 * 1024, '\0');
+    for (size_t offset = 0; offset < size; offset += block.size()) {
+        size_t len = std::min(block.size(), size - offset);
+        for (size_t i = 0; i < len; ++i) {
+            block[i] = pattern_at(offset + i);
+        }
+        if (write(fd, block.data(), len) != static_cast<ssize_t>(len)) {
+            close(fd);
+            return false;
+        }
+    }
+    close(fd);
+    return true;
+}
+
+// Petit buffer de réception: le serveur remplit son socket bien avant la fin du corps
+int open_client(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int rcvbuf = 16 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    struct timeval timeout = {10, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+bool wait_for_server(int port) {
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        int fd = open_client(port);
+        if (fd >= 0) {
+            close(fd);
+            return true;
+        }
+        usleep(100 * 1000);
+    }
+    return false;
+}
+
+// GET avec Connection: close, corps lu jusqu'à la fermeture
+bool download(int port, const std::string& path, size_t expected) {
+    int fd = open_client(port);
+    if (fd < 0) {
+        std::fprintf(stderr, "%s: connexion impossible\n", path.c_str());
+        return false;
+    }
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+        close(fd);
+        return false;
+    }
+
+    // Laisser le serveur buter sur EAGAIN avant de lire
+    usleep(300 * 1000);
+
+    std::string head;
+    bool head_done = false;
+    size_t body = 0;
+    bool intact = true;
+    char buffer[65536];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        size_t offset = 0;
+        if (!head_done) {
+            head.append(buffer, n);
+            size_t end = head.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                continue;
+            }
+            offset = static_cast<size_t>(n) - (head.size() - end - 4);
+            head.resize(end + 4);
+            head_done = true;
+        }
+        for (; offset < static_cast<size_t>(n); ++offset, ++body) {
+            intact = intact && buffer[offset] == pattern_at(body);
+        }
+    }
+    close(fd);
+
+    if (n < 0) {
+        std::fprintf(stderr, "%s: lecture interrompue (%s)\n", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    if (head.compare(0, 12, "HTTP/1.1 200") != 0) {
+        std::fprintf(stderr, "%s: réponse inattendue: %.40s\n", path.c_str(), head.c_str());
+        return false;
+    }
+    if (body != expected || !intact) {
+        std::fprintf(stderr, "%s: %zu octets reçus sur %zu%s\n", path.c_str(), body, expected,
+                     intact ? "" : ", contenu altéré");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s <serveur>\n", argv[0]);
+        return 2;
+    }
+
+    char root_template[] = "/tmp/large_response_XXXXXX";
+    const char* root = mkdtemp(root_template);
+    const std::string file_path = root ? std::string(root) + "/large.bin" : "";
+    int port = free_port();
+    if (!root || port < 0 || !write_file(file_path, FILE_BYTES)) {
+        std::fprintf(stderr, "Préparation du test impossible\n");
+        return 2;
+    }
+
+    pid_t server = fork();
+    if (server == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        dup2(null_fd, STDERR_FILENO);
+        const std::string port_arg = std::to_string(port);
+        const std::string root_arg = std::string("--root=") + root;
+        execl(argv[1], argv[1], port_arg.c_str(), "2", "--bench-routes", root_arg.c_str(),
+              static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    bool ok = wait_for_server(port);
+    if (!ok) {
+        std::fprintf(stderr, "Le serveur n'écoute pas sur le port %d\n", port);
+    }
+    ok = ok && download(port, "/bytes/" + std::to_string(GENERATED_BYTES), GENERATED_BYTES);
+    ok = ok && download(port, "/large.bin", FILE_BYTES);
+
+    // Le serveur doit avoir survécu aux deux envois
+    int status = 0;
+    if (waitpid(server, &status, WNOHANG) != 0) {
+        std::fprintf(stderr, "Le serveur s'est arrêté (%s %d)\n",
+                     WIFSIGNALED(status) ? "signal" : "code", WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+        ok = false;
+    } else {
+        kill(server, SIGTERM);
+        waitpid(server, &status, 0);
+    }
+
+    unlink(file_path.c_str());
+    rmdir(root);
+    std::printf("%s\n", ok ? "OK" : "ÉCHEC");
+    return ok ? 0 : 1;
+}